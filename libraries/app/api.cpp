@@ -27,6 +27,7 @@
 #include <graphene/app/api_access.hpp>
 #include <graphene/app/application.hpp>
 #include <graphene/app/impacted.hpp>
+#include <graphene/account_history/account_history_plugin.hpp>
 #include <graphene/chain/database.hpp>
 #include <graphene/chain/get_config.hpp>
 #include <graphene/utilities/key_conversion.hpp>
@@ -188,6 +189,11 @@ namespace graphene { namespace app {
        return _app.p2p_node()->set_advanced_node_parameters(params);
     }
 
+    pending_pool_stats network_node_api::get_pending_pool_stats() const
+    {
+       return _app.chain_database()->get_pending_pool_stats();
+    }
+
     fc::api<network_broadcast_api> login_api::network_broadcast()const
     {
        FC_ASSERT(_network_broadcast_api);
@@ -408,6 +414,8 @@ namespace graphene { namespace app {
                   break;
                  case impl_das33_pledge_holder_object_type:
                   break;
+                 case impl_das33_distribution_object_type:
+                  break;
           }
        }
        return result;
@@ -458,12 +466,42 @@ namespace graphene { namespace app {
     {
        FC_ASSERT( _app.chain_database() );
        const auto& db = *_app.chain_database();
-       return get_account_history_impl(account,
-                                       [&operation_types, &db](const account_transaction_history_object* node) {
-                                           return operation_types.find(node->operation_id(db).op.which()) != operation_types.end(); },
-                                       stop,
-                                       limit,
-                                       start);
+       FC_ASSERT( limit <= 100 );
+       vector<operation_history_object> result;
+       const auto& hist_idx = db.get_index_type<account_transaction_history_index>();
+       const auto& by_op_idx = hist_idx.indices().get<by_op>();
+       const auto& by_op_type_idx = hist_idx.indices().get<by_op_type>();
+
+       // Find the range of sequence numbers of the account's operations in (stop, start]:
+       auto first = by_op_idx.upper_bound( boost::make_tuple( account, stop ) );
+       auto last = start == operation_history_id_type() ? by_op_idx.upper_bound( boost::make_tuple( account ) )
+                                                        : by_op_idx.upper_bound( boost::make_tuple( account, start ) );
+       if( first == by_op_idx.end() || first->account != account || last == by_op_idx.begin() )
+          return result;
+       --last;
+       if( last->account != account || last->sequence < first->sequence )
+          return result;
+
+       // Take the most recent operations of each type, and keep the most recent of those:
+       vector<const account_transaction_history_object*> nodes;
+       for( uint32_t op_type : operation_types )
+       {
+          auto itr = by_op_type_idx.upper_bound( boost::make_tuple( account, op_type, last->sequence ) );
+          auto itr_stop = by_op_type_idx.lower_bound( boost::make_tuple( account, op_type, first->sequence ) );
+          for( unsigned count = 0; itr != itr_stop && count < limit; ++count )
+             nodes.push_back( &*--itr );
+       }
+       std::sort( nodes.begin(), nodes.end(), []( const account_transaction_history_object* a,
+                                                  const account_transaction_history_object* b ) {
+          return a->sequence > b->sequence;
+       });
+       if( nodes.size() > limit )
+          nodes.resize( limit );
+
+       result.reserve( nodes.size() );
+       for( const auto* node : nodes )
+          result.push_back( node->operation_id(db) );
+       return result;
     }
 
     vector<operation_history_object> history_api::get_relative_account_history( account_id_type account,
@@ -478,17 +516,21 @@ namespace graphene { namespace app {
        if( start == 0 )
          start = account(db).statistics(db).total_ops;
        else start = min( account(db).statistics(db).total_ops, start );
-       const auto& hist_idx = db.get_index_type<account_transaction_history_index>();
-       const auto& by_seq_idx = hist_idx.indices().get<by_seq>();
-
-       auto itr = by_seq_idx.upper_bound( boost::make_tuple( account, start ) );
-       auto itr_stop = by_seq_idx.lower_bound( boost::make_tuple( account, stop ) );
-       --itr;
 
-       while ( itr != itr_stop && result.size() < limit )
+       // The entry at the stop sequence, or the first entry of the account if stop is 0, is not included:
+       const uint32_t lowest = std::max( stop, 1u );
+       while( start > lowest && result.size() < limit )
        {
-          result.push_back( itr->operation_id(db) );
-          --itr;
+          const auto page = get_account_history_page( account, start, std::min<uint32_t>( limit - result.size(), start - lowest ) );
+          if( page.empty() )
+             break;
+          for( const auto& node : page )
+          {
+             auto op = get_operation( node.operation_id );
+             if( op.valid() )
+                result.push_back( std::move( *op ) );
+          }
+          start = page.back().sequence - 1;
        }
 
        return result;
@@ -539,22 +581,74 @@ namespace graphene { namespace app {
         vector<operation_history_object> result;
         const auto& stats = account(db).statistics(db);
         if( stats.most_recent_op == account_transaction_history_id_type() ) return result;
-        const account_transaction_history_object* node = &stats.most_recent_op(db);
-        if( start == operation_history_id_type() )
-            start = node->operation_id;
 
-        while(node && node->operation_id.instance.value > stop.instance.value && result.size() < limit)
+        // Older entries may have left memory, so the history is visited by sequence number instead of through next:
+        uint32_t sequence = stats.total_ops;
+        while( sequence > 0 && result.size() < limit )
         {
-            if( node->operation_id.instance.value <= start.instance.value && selector(node) )
-                result.push_back( node->operation_id(db) );
-            if( node->next == account_transaction_history_id_type() )
-                node = nullptr;
-            else node = &node->next(db);
+            const auto page = get_account_history_page( account, sequence, limit );
+            if( page.empty() )
+                break;
+            for( const auto& node : page )
+            {
+                if( node.operation_id.instance.value <= stop.instance.value )
+                    return result;
+                if( ( start == operation_history_id_type() || node.operation_id.instance.value <= start.instance.value )
+                    && selector( &node ) )
+                {
+                    auto op = get_operation( node.operation_id );
+                    if( op.valid() )
+                        result.push_back( std::move( *op ) );
+                    if( result.size() >= limit )
+                        return result;
+                }
+            }
+            sequence = page.back().sequence - 1;
+        }
+
+        return result;
+    }
+
+    vector<account_transaction_history_object> history_api::get_account_history_page( account_id_type account,
+                                                                                      uint32_t sequence,
+                                                                                      uint32_t count )const
+    {
+        const auto& db = *_app.chain_database();
+        vector<account_transaction_history_object> result;
+        const auto& by_seq_idx = db.get_index_type<account_transaction_history_index>().indices().get<by_seq>();
+        auto itr = by_seq_idx.find( boost::make_tuple( account, sequence ) );
+        if( itr == by_seq_idx.end() )
+        {
+            auto plugin = std::dynamic_pointer_cast<graphene::account_history::account_history_plugin>( _app.get_plugin( "account_history" ) );
+            if( plugin && plugin->store() )
+                return plugin->store()->get_account_history( account, sequence, count );
+            return result;
         }
 
+        while( result.size() < count )
+        {
+            result.push_back( *itr );
+            if( itr == by_seq_idx.begin() )
+                break;
+            --itr;
+            if( itr->account != account )
+                break;
+        }
         return result;
     }
 
+    optional<operation_history_object> history_api::get_operation( operation_history_id_type id )const
+    {
+        const auto& db = *_app.chain_database();
+        const operation_history_object* op = db.find( id );
+        if( op != nullptr )
+            return *op;
+        auto plugin = std::dynamic_pointer_cast<graphene::account_history::account_history_plugin>( _app.get_plugin( "account_history" ) );
+        if( plugin && plugin->store() )
+            return plugin->store()->get_operation( id );
+        return {};
+    }
+
     crypto_api::crypto_api(){};
 
     blind_signature crypto_api::blind_sign( const extended_private_key_type& key, const blinded_hash& hash, int i )
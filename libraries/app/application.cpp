@@ -165,6 +165,10 @@ namespace detail {
          _p2p_network->load_configuration(data_dir / "p2p");
          _p2p_network->set_node_delegate(this);
 
+         if( _options->count("p2p-message-threads") )
+            _p2p_network->set_advanced_node_parameters( fc::mutable_variant_object( "message_processing_threads",
+                                                           _options->at("p2p-message-threads").as<uint32_t>() ) );
+
          if( _options->count("seed-node") )
          {
             auto seeds = _options->at("seed-node").as<vector<string>>();
@@ -377,6 +381,35 @@ namespace detail {
          if( _options->count("replay-blockchain") )
             _chain_db->wipe( _data_dir / "blockchain", false );
 
+         if( _options->count("replay-threads") )
+            _chain_db->set_replay_threads( _options->at("replay-threads").as<uint32_t>() );
+
+         if( _options->count("signature-threads") )
+            _chain_db->set_signature_threads( _options->at("signature-threads").as<uint32_t>() );
+
+         {
+            pending_pool_options pool_options;
+            if( _options->count("pending-pool-size") )
+               pool_options.max_size = _options->at("pending-pool-size").as<uint32_t>();
+            if( _options->count("pending-pool-account-quota") )
+               pool_options.account_quota = _options->at("pending-pool-account-quota").as<uint32_t>();
+            if( _options->count("pending-pool-operation-priority") )
+            {
+               for( const auto& pp : _options->at("pending-pool-operation-priority").as<vector<string>>() )
+               {
+                  auto item = fc::json::from_string(pp).as<std::pair<int,int32_t> >();
+                  pool_options.operation_priorities[item.first] = item.second;
+               }
+            }
+            _chain_db->set_pending_pool_options( pool_options );
+         }
+
+         if( _options->count("mmap-block-database") )
+         {
+            ilog( "Block database reads will use memory mapped files" );
+            _chain_db->set_block_database_mmap_reads( true );
+         }
+
          try
          {
             _chain_db->open( _data_dir / "blockchain", initial_state, GRAPHENE_CURRENT_DB_VERSION );
@@ -923,6 +956,17 @@ void application::set_program_options(boost::program_options::options_descriptio
          ("genesis-json", bpo::value<boost::filesystem::path>(), "File to read Genesis State from")
          ("dbg-init-key", bpo::value<string>(), "Block signing key to use for init witnesses, overrides genesis file")
          ("api-access", bpo::value<boost::filesystem::path>(), "JSON file specifying API permissions")
+         ("signature-threads", bpo::value<uint32_t>(), "Number of threads recovering transaction signature keys of "
+                                                       "validated blocks, defaults to the number of hardware threads")
+         ("p2p-message-threads", bpo::value<uint32_t>(), "Number of threads reading and decoding the messages of P2P "
+                                                         "peers, 0 (the default) to do it on the P2P thread")
+         ("pending-pool-size", bpo::value<uint32_t>(), "Maximum number of pending transactions, 0 (the default) for no limit")
+         ("pending-pool-account-quota", bpo::value<uint32_t>(), "Maximum number of pending transactions paid by a single "
+                                                                "account, 0 (the default) for no limit")
+         ("pending-pool-operation-priority", bpo::value<vector<string>>()->composing(), "Pairs of [OPERATION_TAG,PRIORITY] "
+                                             "ordering pending transactions in generated blocks, higher priorities first")
+         ("mmap-block-database", "Read blocks through memory mapped block database files, so API, P2P and replay "
+                                 "reads can run concurrently, disabled by default")
          ;
    command_line_options.add(configuration_file_options);
    command_line_options.add_options()
@@ -932,6 +976,7 @@ void application::set_program_options(boost::program_options::options_descriptio
           "invalid file is found, it will be replaced with an example Genesis State.")
          ("replay-blockchain", "Rebuild object graph by replaying all blocks")
          ("resync-blockchain", "Delete all blocks and re-sync with network from scratch")
+         ("replay-threads", bpo::value<uint32_t>(), "Number of threads that prepare blocks ahead of a replay, 0 to replay on a single thread")
          ("force-validate", "Force validation of all transactions")
          ("genesis-timestamp", bpo::value<uint32_t>(), "Replace timestamp from genesis.json with current time plus this many seconds (experts only!)")
          ;
@@ -998,6 +1043,11 @@ std::shared_ptr<chain::database> application::chain_database() const
    return my->_chain_db;
 }
 
+const fc::path& application::data_dir() const
+{
+   return my->_data_dir;
+}
+
 void application::set_block_production(bool producing_blocks)
 {
    my->_is_block_producer = producing_blocks;
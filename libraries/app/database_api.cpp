@@ -206,6 +206,8 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       vector<das33_pledge_holder_object> get_das33_pledges_by_project(das33_project_id_type project, das33_pledge_holder_id_type from, uint32_t limit) const;
       vector<das33_project_object> get_das33_projects(const string& lower_bound_name, uint32_t limit) const;
       vector<asset> get_amount_of_assets_pledged_to_project(das33_project_id_type project) const;
+      vector<asset> get_amount_of_assets_pledged_to_project_in_phase(das33_project_id_type project, share_type phase) const;
+      const das33_pledge_totals_index& get_das33_pledge_totals() const;
       das33_project_tokens_amount get_amount_of_project_tokens_received_for_asset(das33_project_id_type project, asset to_pledge) const;
       das33_project_tokens_amount get_amount_of_asset_needed_for_project_token(das33_project_id_type project, asset_id_type asset_id, asset tokens) const;
 
@@ -662,22 +664,10 @@ optional<total_cycles_res> database_api::get_total_cycles() const {
 }
 
 optional<total_cycles_res> database_api_impl::get_total_cycles() const {
-    total_cycles_res result;
-    const auto& accounts = _db.get_index_type<account_index>().indices().get<by_id>();
-
-    for (const account_object& acc : accounts)
-    {
-        if (acc.is_vault())
-        {
-            optional<total_cycles_res> vaultCycles = _dal.get_total_cycles(acc.get_id());     
-            if (vaultCycles.valid())
-            {
-                result.total_cycles += vaultCycles->total_cycles;
-                result.total_dascoin += vaultCycles->total_dascoin;
-            }
-        }
-    }
-    return result;
+    const auto& idx = _db.get_index_type<license_information_index>();
+    const auto& license_idx = dynamic_cast<const primary_index<license_information_index>&>(idx);
+    const auto& totals = license_idx.get_secondary_index<license_totals_index>();
+    return total_cycles_res{totals.total_cycles(), totals.total_dascoin()};
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -1295,82 +1285,77 @@ limit_orders_grouped_by_price database_api::get_limit_orders_grouped_by_price(as
 
 limit_orders_grouped_by_price database_api_impl::get_limit_orders_grouped_by_price(asset_id_type base, asset_id_type quote, uint32_t limit)const
 {
-   const auto& limit_order_idx = _db.get_index_type<limit_order_index>();
-   const auto& limit_price_idx = limit_order_idx.indices().get<by_price>();
+   const auto& idx = _db.get_index_type<limit_order_index>();
+   const auto& limit_order_idx = dynamic_cast<const primary_index<limit_order_index>&>(idx);
+   const auto& price_levels = limit_order_idx.get_secondary_index<limit_order_price_level_index>().levels();
 
    limit_orders_grouped_by_price result;
    if(base < quote)
       std::swap(base,quote);
 
 
-   auto func = [this, &limit_price_idx, limit](asset_id_type& a, asset_id_type& b, std::vector<agregated_limit_orders_with_same_price>& ret, bool ascending){
+   auto func = [this, &price_levels, limit](asset_id_type& a, asset_id_type& b, std::vector<agregated_limit_orders_with_same_price>& ret, bool ascending){
       std::map<share_type, agregated_limit_orders_with_same_price> helper_map;
 
-      auto limit_itr = limit_price_idx.lower_bound(price::max(a,b));
-      auto limit_end = limit_price_idx.upper_bound(price::min(a,b));
+      auto level_itr = price_levels.lower_bound(price::max(a,b));
+      auto level_end = price_levels.upper_bound(price::min(a,b));
 
       auto& asset_a = _db.get(a);
       auto& asset_b = _db.get(b);
       double coef = asset::scaled_precision(asset_a.precision).value * 1.0 / asset::scaled_precision(asset_b.precision).value;
 
-      while(limit_itr != limit_end)
+      // Levels come best price first, so the price keys are monotonic and we can stop at the first key past the limit
+      while(level_itr != level_end)
       {
-         double price = ascending ? 1 / limit_itr->sell_price.to_real() : limit_itr->sell_price.to_real();
+         double price = ascending ? 1 / level_itr->first.to_real() : level_itr->first.to_real();
          // adjust price precision and value accordingly so we can forme key
          auto p = round((ascending ? price * coef : price / coef) * DASCOIN_FIAT_ASSET_PRECISION);
          share_type price_key = static_cast<share_type>(p);
+         const auto& level = level_itr->second;
 
          auto helper_itr = helper_map.find(price_key);
 
-         // if we are adding limit order with new price
+         // if we are adding limit orders with new price
          if(helper_itr == helper_map.end())
          {
+            if(helper_map.size() >= limit)
+               break;
+
             agregated_limit_orders_with_same_price alo;
             alo.price = price_key;
-            alo.base_volume = limit_itr->for_sale.value;
-            alo.quote_volume = round(ascending ? limit_itr->for_sale.value * price : limit_itr->for_sale.value / price);
-            alo.count = 1;
+            alo.base_volume = level.for_sale;
+            alo.quote_volume = level.quote_volume;
+            alo.count = level.count;
 
             helper_map[price_key] = alo;
          }
          else
          {
-            helper_itr->second.base_volume += limit_itr->for_sale.value;;
-            helper_itr->second.quote_volume += round(ascending ? limit_itr->for_sale.value * price : limit_itr->for_sale.value / price);
-            helper_itr->second.count++;
+            helper_itr->second.base_volume += level.for_sale;
+            helper_itr->second.quote_volume += level.quote_volume;
+            helper_itr->second.count += level.count;
          }
 
-         ++limit_itr;
+         ++level_itr;
       }
 
       // re-pack result in vector (from map) in desired order
-      uint32_t count = 0;
       if(ascending)
       {
-         auto helper_itr = helper_map.begin();
-         while(helper_itr != helper_map.end() && count < limit)
-         {
+         for(auto helper_itr = helper_map.begin(); helper_itr != helper_map.end(); ++helper_itr)
             ret.push_back(helper_itr->second);
-            helper_itr++;
-            count++;
-         }
       }
       else
       {
-         auto helper_itr = helper_map.rbegin();
-         while(helper_itr != helper_map.rend() && count < limit)
-         {
+         for(auto helper_itr = helper_map.rbegin(); helper_itr != helper_map.rend(); ++helper_itr)
             ret.push_back(helper_itr->second);
-            helper_itr++;
-            count++;
-         }
       }
    };
 
    func(base, quote, result.sell, true);
    func(quote, base, result.buy, false);
 
-   return std::move(result);
+   return result;
 }
 
 limit_orders_collection_grouped_by_price database_api::get_limit_orders_collection_grouped_by_price(asset_id_type a, asset_id_type b, uint32_t limit_group, uint32_t limit_per_group) const
@@ -1421,52 +1406,65 @@ void database_api_impl::func_re_pack(IterStart helper_itr, IterEnd end, std::vec
 limit_orders_collection_grouped_by_price database_api_impl::get_limit_orders_collection_grouped_by_price(asset_id_type base, asset_id_type quote, uint32_t limit_group, uint32_t limit_per_group) const
 {
    FC_ASSERT( limit_per_group <= 100 && limit_group <= 100);
-   const auto& limit_order_idx = _db.get_index_type<limit_order_index>();
-   const auto& limit_price_idx = limit_order_idx.indices().get<by_price>();
+   const auto& idx = _db.get_index_type<limit_order_index>();
+   const auto& limit_order_idx = dynamic_cast<const primary_index<limit_order_index>&>(idx);
+   const auto& price_levels = limit_order_idx.get_secondary_index<limit_order_price_level_index>().levels();
 
    limit_orders_collection_grouped_by_price result;
    if(base < quote)
       std::swap(base,quote);
 
 
-   auto func = [this, &limit_price_idx, limit_group, limit_per_group](asset_id_type& a, asset_id_type& b, std::vector<agregated_limit_orders_with_same_price_collection>& ret, bool ascending){
+   auto func = [this, &price_levels, limit_group, limit_per_group](asset_id_type& a, asset_id_type& b, std::vector<agregated_limit_orders_with_same_price_collection>& ret, bool ascending){
       std::map<share_type, agregated_limit_orders_with_same_price> helper_map;
 
-      auto limit_itr = limit_price_idx.lower_bound(price::max(a,b));
-      auto limit_end = limit_price_idx.upper_bound(price::min(a,b));
+      auto level_itr = price_levels.lower_bound(price::max(a,b));
+      auto level_end = price_levels.upper_bound(price::min(a,b));
 
       auto& asset_a = _db.get(a);
       auto& asset_b = _db.get(b);
       double coef = asset::scaled_precision(asset_a.precision).value * 1.0 / asset::scaled_precision(asset_b.precision).value;
 
-      while(limit_itr != limit_end)
+      // Levels come best price first, so the group keys are monotonic and we can stop at the first group past the limit
+      uint32_t group_count = 0;
+      optional<share_type> last_group_key;
+      while(level_itr != level_end)
       {
-         double price = ascending ? 1 / limit_itr->sell_price.to_real() : limit_itr->sell_price.to_real();
+         double price = ascending ? 1 / level_itr->first.to_real() : level_itr->first.to_real();
          // adjust price precision and value accordingly so we can forme key
          auto p = round((ascending ? price * coef : price / coef) * ORDER_BOOK_QUERY_PRECISION);
          share_type price_key = static_cast<share_type>(p);
+         const auto& level = level_itr->second;
+
+         share_type group_key = static_cast<share_type>(price_key / ORDER_BOOK_GROUP_QUERY_PRECISION_DIFF);
+         if(!last_group_key.valid() || *last_group_key != group_key)
+         {
+            if(group_count >= limit_group)
+               break;
+            ++group_count;
+            last_group_key = group_key;
+         }
 
          auto helper_itr = helper_map.find(price_key);
 
-         share_type quote_amount = round(ascending ? limit_itr->for_sale.value * price : limit_itr->for_sale.value / price);
-         // if we are adding limit order with new price
+         // if we are adding limit orders with new price
          if(helper_itr == helper_map.end())
          {
             agregated_limit_orders_with_same_price alo;
             alo.price = price_key;
-            alo.base_volume = limit_itr->for_sale.value;
-            alo.quote_volume = quote_amount;
-            alo.count = 1;
+            alo.base_volume = level.for_sale;
+            alo.quote_volume = level.quote_volume;
+            alo.count = level.count;
             helper_map[price_key] = alo;
          }
          else
          {
-            helper_itr->second.base_volume += limit_itr->for_sale.value;
-            helper_itr->second.quote_volume += quote_amount;
-            helper_itr->second.count++;
+            helper_itr->second.base_volume += level.for_sale;
+            helper_itr->second.quote_volume += level.quote_volume;
+            helper_itr->second.count += level.count;
          }
 
-         ++limit_itr;
+         ++level_itr;
       }
 
       // re-pack result in vector (from map) in desired order
@@ -1483,7 +1481,7 @@ limit_orders_collection_grouped_by_price database_api_impl::get_limit_orders_col
    func(base, quote, result.sell, true);
    func(quote, base, result.buy, false);
 
-   return std::move(result);
+   return result;
 }
 
 
@@ -1574,11 +1572,8 @@ market_ticker database_api_impl::get_ticker( const string& base, const string& q
    FC_ASSERT( assets[0], "Invalid base asset symbol: ${s}", ("s",base) );
    FC_ASSERT( assets[1], "Invalid quote asset symbol: ${s}", ("s",quote) );
 
-   const fc::time_point_sec now = fc::time_point::now();
-   const fc::time_point_sec yesterday = fc::time_point_sec( now.sec_since_epoch() - 86400 );
-
    market_ticker result;
-   result.time = now;
+   result.time = _db.head_block_time();
    result.base = base;
    result.quote = quote;
    result.latest = 0;
@@ -1592,11 +1587,6 @@ market_ticker database_api_impl::get_ticker( const string& base, const string& q
    auto quote_id = assets[1]->id;
    if( base_id > quote_id ) std::swap( base_id, quote_id );
 
-   history_key hkey;
-   hkey.base = base_id;
-   hkey.quote = quote_id;
-   hkey.sequence = std::numeric_limits<int64_t>::min();
-
    // TODO: move following duplicate code out
    // TODO: using pow is a bit inefficient here, optimization is possible
    auto asset_to_real = [&]( const asset& a, int p ) { return double(a.amount.value)/pow( 10, p ); };
@@ -1608,54 +1598,23 @@ market_ticker database_api_impl::get_ticker( const string& base, const string& q
         return asset_to_real( p.quote, assets[0]->precision ) / asset_to_real( p.base, assets[1]->precision );
   };
 
-   const auto& history_idx = _db.get_index_type<graphene::market_history::history_index>().indices().get<by_key>();
-   auto itr = history_idx.lower_bound( hkey );
-
-   bool is_latest = true;
-   price latest_price;
-   fc::uint128 base_volume;
-   fc::uint128 quote_volume;
-   while( itr != history_idx.end() && itr->key.base == base_id && itr->key.quote == quote_id )
+   const auto& ticker_idx = _db.get_index_type<graphene::market_history::market_ticker_index>()
+                               .indices().get<graphene::market_history::by_market>();
+   auto itr = ticker_idx.find( std::make_tuple( base_id, quote_id ) );
+   if( itr != ticker_idx.end() )
    {
-     if( is_latest )
-     {
-        is_latest = false;
-        latest_price = itr->op.fill_price;
-        result.latest = price_to_real( latest_price );
-     }
-
-     if( itr->time < yesterday )
-     {
-        if( itr->op.fill_price != latest_price )
-          result.percent_change = ( result.latest / price_to_real( itr->op.fill_price ) - 1 ) * 100;
-        break;
-     }
-
-     if( itr->op.is_maker )
-     {
-        if( assets[0]->id == itr->op.receives.asset_id )
-        {
-           base_volume += itr->op.receives.amount.value;
-           quote_volume += itr->op.pays.amount.value;
-        }
-        else
-        {
-           base_volume += itr->op.pays.amount.value;
-           quote_volume += itr->op.receives.amount.value;
-        }
-     }
-
-     ++itr;
+      result.latest = price_to_real( itr->latest_price );
+      if( itr->previous_price.valid() && *itr->previous_price != itr->latest_price )
+         result.percent_change = ( result.latest / price_to_real( *itr->previous_price ) - 1 ) * 100;
+
+      // The ticker keeps its volumes with the lower asset id as base
+      const bool flipped = ( assets[0]->id != itr->base );
+      const share_type base_volume = flipped ? itr->quote_volume : itr->base_volume;
+      const share_type quote_volume = flipped ? itr->base_volume : itr->quote_volume;
+      result.base_volume = double( base_volume.value ) / pow( 10, assets[0]->precision );
+      result.quote_volume = double( quote_volume.value ) / pow( 10, assets[1]->precision );
    }
 
-   auto uint128_to_double = []( const fc::uint128& n )
-   {
-      if( n.hi == 0 ) return double( n.lo );
-         return double(n.hi) * (uint64_t(1)<<63) * 2 + n.lo;
-   };
-   result.base_volume = uint128_to_double( base_volume ) / pow( 10, assets[0]->precision );
-   result.quote_volume = uint128_to_double( quote_volume ) / pow( 10, assets[1]->precision );
-
    const auto orders = get_order_book( base, quote, 1 );
    if( !orders.asks.empty() ) result.lowest_ask = orders.asks[0].price;
    if( !orders.bids.empty() ) result.highest_bid = orders.bids[0].price;
@@ -1688,43 +1647,32 @@ market_hi_low_volume database_api_impl::get_24_hi_low_volume( const string& base
    try {
       if( base_id > quote_id ) std::swap(base_id, quote_id);
 
-      auto now = fc::time_point_sec( fc::time_point::now() );
-      auto ts = now - fc::days(1).to_seconds();
-
-      auto trades = get_trade_history( base, quote, now, ts, 100 );
-
-      if( !trades.empty() )
-      {
-         result.high = trades[0].price;
-         result.low = trades[0].price;
-      }
-
-      for ( market_trade t: trades )
+      auto asset_to_real = [&]( const asset& a, int p ) { return double(a.amount.value)/pow( 10, p ); };
+      auto price_to_real = [&]( const price& p )
       {
-         if( result.high < t.price )
-            result.high = t.price;
-         if( result.low > t.price )
-            result.low = t.price;
-
-         result.base_volume += t.value;
-         result.quote_volume += t.amount;
-      }
+        if( p.base.asset_id == assets[0]->id )
+           return asset_to_real( p.base, assets[0]->precision ) / asset_to_real( p.quote, assets[1]->precision );
+        else
+           return asset_to_real( p.quote, assets[0]->precision ) / asset_to_real( p.base, assets[1]->precision );
+      };
 
-      while (trades.size() == 100)
-      {
-         trades = get_trade_history_by_sequence( base, quote, trades[99].sequence, ts, 100 );
+      const auto& ticker_idx = _db.get_index_type<graphene::market_history::market_ticker_index>()
+                                  .indices().get<graphene::market_history::by_market>();
+      auto itr = ticker_idx.find( std::make_tuple( base_id, quote_id ) );
+      if( itr == ticker_idx.end() || itr->trade_count == 0 )
+         return result;
 
-         for ( market_trade t: trades )
-         {
-           if( result.high < t.price )
-              result.high = t.price;
-           if( result.low > t.price )
-              result.low = t.price;
+      // Inverting the price swaps the high and the low, so order them after the conversion
+      const double high = price_to_real( itr->high );
+      const double low = price_to_real( itr->low );
+      result.high = std::max( high, low );
+      result.low = std::min( high, low );
 
-           result.base_volume += t.value;
-           result.quote_volume += t.amount;
-         }
-      }
+      const bool flipped = ( assets[0]->id != itr->base );
+      const share_type base_volume = flipped ? itr->quote_volume : itr->base_volume;
+      const share_type quote_volume = flipped ? itr->base_volume : itr->quote_volume;
+      result.base_volume = double( base_volume.value ) / pow( 10, assets[0]->precision );
+      result.quote_volume = double( quote_volume.value ) / pow( 10, assets[1]->precision );
 
       return result;
    } FC_CAPTURE_AND_RETHROW( (base)(quote) )
@@ -2774,38 +2722,20 @@ vector<dasc_holder> database_api::get_top_dasc_holders() const
 vector<dasc_holder> database_api_impl::get_top_dasc_holders() const
 {
     static const uint32_t max_holders = 100;
-    vector<dasc_holder> tmp;
-    const auto& dasc_id = _db.get_dascoin_asset_id();
-    const auto& idx = _db.get_index_type<account_index>().indices().get<by_id>();
-    for ( auto it = idx.cbegin(); it != idx.cend(); ++it )
+    const auto& idx = _db.get_index_type<account_balance_index>();
+    const auto& balance_idx = dynamic_cast<const primary_index<account_balance_index>&>(idx);
+    const auto& ranking = balance_idx.get_secondary_index<dasc_holder_index>().ranking();
+
+    vector<dasc_holder> ret;
+    ret.reserve(std::min<size_t>(max_holders, ranking.size()));
+    for ( auto it = ranking.begin(); it != ranking.end() && ret.size() < max_holders; ++it )
     {
-        const auto& account = *it;
         dasc_holder holder;
-        holder.holder = account.id;
-        if (account.kind == account_kind::wallet)
-        {
-            holder.vaults = account.vault.size();
-            const auto& balance_obj = _db.get_balance_object(account.id, dasc_id);
-            holder.amount = balance_obj.balance + balance_obj.reserved;
-            std::for_each(account.vault.begin(), account.vault.end(), [this, &holder, &dasc_id](const account_id_type& vault_id) {
-                const auto& balance_obj = _db.get_balance_object(vault_id, dasc_id);
-                holder.amount += balance_obj.balance;
-            });
-            tmp.emplace_back(holder);
-        }
-        else if (account.kind == account_kind::custodian || (account.kind == account_kind::vault && account.parents.empty()))
-        {
-            holder.vaults = 0;
-            const auto& balance_obj = _db.get_balance_object(account.id, dasc_id);
-            holder.amount = balance_obj.balance;
-            tmp.emplace_back(holder);
-        }
+        holder.holder = it->id;
+        holder.vaults = it->vaults;
+        holder.amount = it->amount;
+        ret.emplace_back(holder);
     }
-
-    std::partial_sort(tmp.begin(), tmp.begin() + max_holders, tmp.end(), [](dasc_holder& a, dasc_holder& b) {
-        return a.amount > b.amount;
-    });
-    vector<dasc_holder> ret(tmp.begin(), tmp.begin() + max_holders);
     return ret;
 }
 
@@ -2901,55 +2831,34 @@ vector<das33_pledge_holder_object> database_api_impl::get_das33_pledges(das33_pl
     return result;
 }
 
+const das33_pledge_totals_index& database_api_impl::get_das33_pledge_totals() const
+{
+    const auto& idx = _db.get_index_type<das33_pledge_holder_index>();
+    const auto& pledge_idx = dynamic_cast<const primary_index<das33_pledge_holder_index>&>(idx);
+    return pledge_idx.get_secondary_index<das33_pledge_totals_index>();
+}
+
 das33_pledges_by_account_result database_api_impl::get_das33_pledges_by_account(account_id_type account) const
 {
-    vector<das33_pledge_holder_object> pledges;
-    map<das33_project_id_type, share_type> total;
-    map<das33_project_id_type, share_type> last_round;
+    das33_pledges_by_account_result result;
 
     const auto& idx = _db.get_index_type<das33_pledge_holder_index>().indices().get<by_user>().equal_range(account);
-    std::copy(idx.first, idx.second, std::back_inserter(pledges));
+    std::copy(idx.first, idx.second, std::back_inserter(result.pledges));
 
-    map<das33_project_id_type, share_type> last_round_number;
-    for (u_int i = 0; i < pledges.size(); i++)
+    const auto* totals = get_das33_pledge_totals().find(account);
+    if (totals)
     {
-      das33_project_id_type project_id = pledges[i].project_id;
-      share_type round_number = pledges[i].phase_number;
-      if (total.find(project_id) != total.end())
-      {
-         total[project_id] = total[project_id] + pledges[i].base_expected.amount + pledges[i].bonus_expected.amount;
-      }
-      else
-      {
-        total[project_id] = pledges[i].base_expected.amount + pledges[i].bonus_expected.amount;
-      }
-      if (last_round_number.find(project_id) != last_round_number.end())
+      for (const auto& project : *totals)
       {
-        if (last_round_number[project_id] < round_number)
-          last_round_number[project_id] = round_number;
-      }
-      else
-      {
-          last_round_number[project_id] = round_number;
-      }
-    }
-    for (u_int j = 0; j < pledges.size(); j++)
-    {
-      das33_project_id_type project_id = pledges[j].project_id;
-      share_type round_number = pledges[j].phase_number;
-      if (round_number == last_round_number[project_id])
-      {
-        if (last_round.find(project_id) != last_round.end())
-          last_round[project_id] = last_round[project_id] + pledges[j].base_expected.amount;
-        else
-          last_round[project_id] = pledges[j].base_expected.amount;
+        share_type total = 0;
+        for (const auto& phase : project.second)
+          total += phase.second.base + phase.second.bonus;
+        result.total_expected[project.first] = total;
+        // Phases are ordered, so the last one is the last round the account pledged in:
+        result.base_expected_in_last_round[project.first] = project.second.rbegin()->second.base;
       }
     }
 
-    das33_pledges_by_account_result result;
-    result.pledges = pledges;
-    result.total_expected = total;
-    result.base_expected_in_last_round = last_round;
     return result;
 }
 
@@ -3004,26 +2913,31 @@ vector<asset> database_api::get_amount_of_assets_pledged_to_project(das33_projec
 vector<asset> database_api_impl::get_amount_of_assets_pledged_to_project(das33_project_id_type project) const
 {
   vector<asset> result;
-  map<asset_id_type, int> index_map;
 
-  auto default_pledge_id = das33_pledge_holder_id_type();
+  const auto* totals = get_das33_pledge_totals().find(project);
+  if (totals)
+    for (const auto& pledged : totals->pledged)
+      result.emplace_back(pledged.second, pledged.first);
 
-  const auto& pledges = _db.get_index_type<das33_pledge_holder_index>().indices().get<by_project>();
-  for( auto itr = pledges.lower_bound(project); itr != pledges.upper_bound(project); ++itr )
-  {
-   if (itr->id != default_pledge_id)
-   {
-     if (index_map.find(itr->pledged.asset_id) != index_map.end())
-     {
-       result[index_map[itr->pledged.asset_id]] += itr->pledged;
-     }
-     else
-     {
-       index_map[itr->pledged.asset_id] = result.size();
-       result.emplace_back(itr->pledged);
-     }
-   }
-  }
+  return result;
+}
+
+vector<asset> database_api::get_amount_of_assets_pledged_to_project_in_phase(das33_project_id_type project, share_type phase) const
+{
+  return my->get_amount_of_assets_pledged_to_project_in_phase(project, phase);
+}
+
+vector<asset> database_api_impl::get_amount_of_assets_pledged_to_project_in_phase(das33_project_id_type project, share_type phase) const
+{
+  vector<asset> result;
+
+  const auto* totals = get_das33_pledge_totals().find(project);
+  if (!totals)
+    return result;
+  auto itr = totals->pledged_by_phase.find(phase);
+  if (itr != totals->pledged_by_phase.end())
+    for (const auto& pledged : itr->second)
+      result.emplace_back(pledged.second, pledged.first);
 
   return result;
 }
@@ -136,6 +136,15 @@ namespace graphene { namespace app {
                                                                    unsigned limit = 100,
                                                                    operation_history_id_type start = operation_history_id_type())const;
 
+         /**
+          * @return at most count entries of the history of an account, from the one with the given sequence number
+          * backwards, taken from memory or, once they have left memory, from the history store
+          */
+         vector<account_transaction_history_object> get_account_history_page( account_id_type account,
+                                                                              uint32_t sequence,
+                                                                              uint32_t count )const;
+         optional<operation_history_object> get_operation( operation_history_id_type id )const;
+
       private:
          application& _app;
    };
@@ -232,6 +241,11 @@ namespace graphene { namespace app {
           */
          std::vector<net::potential_peer_record> get_potential_peers() const;
 
+         /**
+          * @brief Return the size, limits and rejection counters of the pending transaction pool
+          */
+         pending_pool_stats get_pending_pool_stats() const;
+
       private:
          application& _app;
    };
@@ -352,6 +366,7 @@ FC_API(graphene::app::network_node_api,
        (get_potential_peers)
        (get_advanced_node_parameters)
        (set_advanced_node_parameters)
+       (get_pending_pool_stats)
      )
 FC_API(graphene::app::crypto_api,
        (blind_sign)
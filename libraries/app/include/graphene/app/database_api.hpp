@@ -991,6 +991,14 @@ class database_api
        */
       vector<asset> get_amount_of_assets_pledged_to_project(das33_project_id_type project) const;
 
+      /**
+       * @brief Gets a sum of all pledges made to project in one phase
+       * @params project id of a project
+       * @params phase number of the phase
+       * @return vector of assets, each with total sum of that asset pledged in the phase
+       */
+      vector<asset> get_amount_of_assets_pledged_to_project_in_phase(das33_project_id_type project, share_type phase) const;
+
       /**
        * @brief Gets the amount of project tokens that a pledger can get for pledging a certain amount of asset
        * @params project id of a project
@@ -1197,6 +1205,7 @@ FC_API( graphene::app::database_api,
    (get_das33_pledges_by_project)
    (get_das33_projects)
    (get_amount_of_assets_pledged_to_project)
+   (get_amount_of_assets_pledged_to_project_in_phase)
    (get_amount_of_project_tokens_received_for_asset)
    (get_amount_of_asset_needed_for_project_token)
 
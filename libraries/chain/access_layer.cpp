@@ -223,7 +223,7 @@ vector<reward_queue_object> database_access_layer::get_reward_queue() const
 
 vector<reward_queue_object> database_access_layer::get_reward_queue_by_page(uint32_t from, uint32_t amount) const
 {
-    return get_range<reward_queue_index, by_time>(from, amount);
+    return get_ranked_range<reward_queue_index, by_time>(from, amount);
 }
 
 vector<frequency_history_record_object> database_access_layer::get_frequency_history() const
@@ -249,7 +249,7 @@ acc_id_queue_subs_w_pos_res database_access_layer::get_queue_submissions_with_po
 
     const auto& range = account_idx.equal_range(account_id);
     for (auto it = range.first; it != range.second; ++it) {
-        uint32_t pos = distance(time_idx.begin(), queue_multi_idx.project<by_time>(it));
+        uint32_t pos = time_idx.rank(queue_multi_idx.project<by_time>(it));
         result.emplace_back(pos, *it);
     }
 
@@ -267,4 +267,135 @@ void account_referrer_index::object_modified( const object& after  )
 {
 }
 
+void dasc_holder_index::object_inserted( const object& obj )
+{
+   assert( dynamic_cast<const account_balance_object*>(&obj) ); // for debug only
+   const auto& b = static_cast<const account_balance_object&>(obj);
+   set_balance( b, b.balance, b.reserved );
+}
+
+void dasc_holder_index::object_removed( const object& obj )
+{
+   assert( dynamic_cast<const account_balance_object*>(&obj) ); // for debug only
+   set_balance( static_cast<const account_balance_object&>(obj), 0, 0 );
+}
+
+void dasc_holder_index::about_to_modify( const object& before )
+{
+}
+
+void dasc_holder_index::object_modified( const object& after  )
+{
+   object_inserted( after );
+}
+
+void dasc_holder_index::set_balance( const account_balance_object& b, share_type balance, share_type reserved )
+{
+   if( b.asset_type != asset_id_type(DASCOIN_DASCOIN_INDEX) )
+      return;
+   auto& info = _accounts[b.owner];
+   if( info.balance == balance && info.reserved == reserved )
+      return;
+   info.balance = balance;
+   info.reserved = reserved;
+   update( b.owner, info.parents );
+}
+
+void dasc_holder_index::account_changed( const account_object& a )
+{
+   auto& info = _accounts[a.id];
+   const auto old_parents = info.parents;
+   info.kind = a.kind;
+   info.parents = a.parents;
+   info.vaults = a.vault;
+   update( a.id, old_parents );
+}
+
+void dasc_holder_index::account_removed( const account_object& a )
+{
+   auto& info = _accounts[a.id];
+   const auto old_parents = info.parents;
+   info.kind.reset();
+   info.parents.clear();
+   info.vaults.clear();
+   update( a.id, old_parents );
+}
+
+void dasc_holder_index::update( account_id_type id, const flat_set<account_id_type>& old_parents )
+{
+   update_holder( id );
+   for( const auto& parent : old_parents )
+      update_holder( parent );
+   for( const auto& parent : _accounts[id].parents )
+      if( old_parents.find( parent ) == old_parents.end() )
+         update_holder( parent );
+}
+
+void dasc_holder_index::update_holder( account_id_type id )
+{
+   auto existing = _holders.find( id );
+   if( existing != _holders.end() )
+   {
+      _ranking.erase( existing->second );
+      _holders.erase( existing );
+   }
+
+   auto itr = _accounts.find( id );
+   if( itr == _accounts.end() || !itr->second.kind.valid() )
+      return;
+   const auto& info = itr->second;
+
+   holder h;
+   h.id = id;
+   switch( *info.kind )
+   {
+      case account_kind::wallet:
+         // A wallet holds its own cash and reserved DASC and the cash of its vaults:
+         h.vaults = info.vaults.size();
+         h.amount = info.balance + info.reserved;
+         for( const auto& vault : info.vaults )
+         {
+            auto vault_itr = _accounts.find( vault );
+            if( vault_itr != _accounts.end() )
+               h.amount += vault_itr->second.balance;
+         }
+         break;
+      case account_kind::custodian:
+         h.amount = info.balance;
+         break;
+      case account_kind::vault:
+         // Tethered vaults are counted with their wallet:
+         if( !info.parents.empty() )
+            return;
+         h.amount = info.balance;
+         break;
+      default:
+         return;
+   }
+   _holders[id] = _ranking.insert( h ).first;
+}
+
+void dasc_holder_account_index::object_inserted( const object& obj )
+{
+   assert( dynamic_cast<const account_object*>(&obj) ); // for debug only
+   if( holders )
+      holders->account_changed( static_cast<const account_object&>(obj) );
+}
+
+void dasc_holder_account_index::object_removed( const object& obj )
+{
+   assert( dynamic_cast<const account_object*>(&obj) ); // for debug only
+   if( holders )
+      holders->account_removed( static_cast<const account_object&>(obj) );
+}
+
+void dasc_holder_account_index::about_to_modify( const object& before )
+{
+}
+
+void dasc_holder_account_index::object_modified( const object& after  )
+{
+   object_inserted( after );
+}
+
 } } // graphene::chain
@@ -26,6 +26,12 @@
 #include <fc/io/raw.hpp>
 #include <fc/smart_ref_impl.hpp>
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/thread/locks.hpp>
+
+#include <cstring>
+
 namespace graphene { namespace chain {
 
 struct index_entry
@@ -39,22 +45,56 @@ FC_REFLECT( graphene::chain::index_entry, (block_pos)(block_size)(block_id) );
 
 namespace graphene { namespace chain {
 
+namespace detail {
+
+/**
+ * Read-only mappings of the index and blocks files, taken at a point in time. Readers hold a reference to the
+ * mapping they are using, so a newer, larger mapping can be published without invalidating reads in progress.
+ */
+struct block_database_mapping
+{
+   boost::interprocess::file_mapping  index_file;
+   boost::interprocess::mapped_region index_region;
+   boost::interprocess::file_mapping  blocks_file;
+   boost::interprocess::mapped_region blocks_region;
+
+   const char* index_data()const { return static_cast<const char*>( index_region.get_address() ); }
+   uint64_t    index_size()const { return index_region.get_size(); }
+   const char* blocks_data()const { return static_cast<const char*>( blocks_region.get_address() ); }
+   uint64_t    blocks_size()const { return blocks_region.get_size(); }
+};
+
+static void map_file( const fc::path& p, boost::interprocess::file_mapping& file, boost::interprocess::mapped_region& region )
+{
+   const uint64_t size = fc::file_size( p );
+   if( size == 0 )
+      return;   // Empty files cannot be mapped, leave the region empty.
+   boost::interprocess::file_mapping f( p.generic_string().c_str(), boost::interprocess::read_only );
+   boost::interprocess::mapped_region r( f, boost::interprocess::read_only, 0, size );
+   file.swap( f );
+   region.swap( r );
+}
+
+} // graphene::chain::detail
+
 void block_database::open( const fc::path& dbdir )
 { try {
    fc::create_directories(dbdir);
    _block_num_to_pos.exceptions(std::ios_base::failbit | std::ios_base::badbit);
    _blocks.exceptions(std::ios_base::failbit | std::ios_base::badbit);
 
+   reset_mapping();
    _index_filename = dbdir / "index";
+   _blocks_filename = dbdir / "blocks";
    if( !fc::exists( _index_filename ) )
    {
      _block_num_to_pos.open( _index_filename.generic_string().c_str(), std::fstream::binary | std::fstream::in | std::fstream::out | std::fstream::trunc);
-     _blocks.open( (dbdir/"blocks").generic_string().c_str(), std::fstream::binary | std::fstream::in | std::fstream::out | std::fstream::trunc);
+     _blocks.open( _blocks_filename.generic_string().c_str(), std::fstream::binary | std::fstream::in | std::fstream::out | std::fstream::trunc);
    }
    else
    {
      _block_num_to_pos.open( _index_filename.generic_string().c_str(), std::fstream::binary | std::fstream::in | std::fstream::out );
-     _blocks.open( (dbdir/"blocks").generic_string().c_str(), std::fstream::binary | std::fstream::in | std::fstream::out );
+     _blocks.open( _blocks_filename.generic_string().c_str(), std::fstream::binary | std::fstream::in | std::fstream::out );
    }
 } FC_CAPTURE_AND_RETHROW( (dbdir) ) }
 
@@ -65,6 +105,7 @@ bool block_database::is_open()const
 
 void block_database::close()
 {
+  reset_mapping();
   _blocks.close();
   _block_num_to_pos.close();
 }
@@ -91,7 +132,15 @@ void block_database::store( const block_id_type& _id, const signed_block& b )
    e.block_size = vec.size();
    e.block_id   = id;
    _blocks.write( vec.data(), vec.size() );
+   boost::unique_lock<boost::shared_mutex> index_guard( _index_mutex, boost::defer_lock );
+   if( _mmap_reads )
+   {
+      _blocks.flush();   // Block data must be visible to the mappings before the index entry pointing to it.
+      index_guard.lock();
+   }
    _block_num_to_pos.write( (char*)&e, sizeof(e) );
+   if( _mmap_reads )
+      _block_num_to_pos.flush();
 }
 
 void block_database::remove( const block_id_type& id )
@@ -108,8 +157,13 @@ void block_database::remove( const block_id_type& id )
    if( e.block_id == id )
    {
       e.block_size = 0;
+      boost::unique_lock<boost::shared_mutex> index_guard( _index_mutex, boost::defer_lock );
+      if( _mmap_reads )
+         index_guard.lock();
       _block_num_to_pos.seekp( sizeof(e) * int64_t(block_header::num_from_id(id)) );
       _block_num_to_pos.write( (char*)&e, sizeof(e) );
+      if( _mmap_reads )
+         _block_num_to_pos.flush();
    }
 } FC_CAPTURE_AND_RETHROW( (id) ) }
 
@@ -118,6 +172,12 @@ bool block_database::contains( const block_id_type& id )const
    if( id == block_id_type() )
       return false;
 
+   if( _mmap_reads )
+   {
+      optional<index_entry> e = mapped_index_entry( block_header::num_from_id(id) );
+      return e.valid() && e->block_id == id && e->block_size > 0;
+   }
+
    index_entry e;
    int64_t index_pos = sizeof(e) * int64_t(block_header::num_from_id(id));
    _block_num_to_pos.seekg( 0, _block_num_to_pos.end );
@@ -132,6 +192,15 @@ bool block_database::contains( const block_id_type& id )const
 block_id_type block_database::fetch_block_id( uint32_t block_num )const
 {
    assert( block_num != 0 );
+   if( _mmap_reads )
+   {
+      optional<index_entry> e = mapped_index_entry( block_num );
+      if( !e.valid() )
+         FC_THROW_EXCEPTION(fc::key_not_found_exception, "Block number ${block_num} not contained in block database", ("block_num", block_num));
+      FC_ASSERT( e->block_id != block_id_type(), "Empty block_id in block_database (maybe corrupt on disk?)" );
+      return e->block_id;
+   }
+
    index_entry e;
    int64_t index_pos = sizeof(e) * int64_t(block_num);
    _block_num_to_pos.seekg( 0, _block_num_to_pos.end );
@@ -149,6 +218,13 @@ optional<signed_block> block_database::fetch_optional( const block_id_type& id )
 {
    try
    {
+      if( _mmap_reads )
+      {
+         optional<index_entry> e = mapped_index_entry( block_header::num_from_id(id) );
+         if( !e.valid() || e->block_id != id ) return optional<signed_block>();
+         return mapped_fetch( *e );
+      }
+
       index_entry e;
       int64_t index_pos = sizeof(e) * int64_t(block_header::num_from_id(id));
       _block_num_to_pos.seekg( 0, _block_num_to_pos.end );
@@ -181,6 +257,13 @@ optional<signed_block> block_database::fetch_by_number( uint32_t block_num )cons
 {
    try
    {
+      if( _mmap_reads )
+      {
+         optional<index_entry> e = mapped_index_entry( block_num );
+         if( !e.valid() ) return optional<signed_block>();
+         return mapped_fetch( *e );
+      }
+
       index_entry e;
       int64_t index_pos = sizeof(e) * int64_t(block_num);
       _block_num_to_pos.seekg( 0, _block_num_to_pos.end );
@@ -246,7 +329,7 @@ optional<index_entry> block_database::last_index_entry()const {
             catch (const std::exception&)
             {
             }
-         fc::resize_file( _index_filename, pos );
+         truncate_index( pos );
       }
    }
    catch (const fc::exception&)
@@ -258,6 +341,79 @@ optional<index_entry> block_database::last_index_entry()const {
    return optional<index_entry>();
 }
 
+optional<index_entry> block_database::mapped_index_entry( uint32_t block_num )const
+{
+   const uint64_t index_pos = sizeof(index_entry) * uint64_t(block_num);
+   const uint64_t index_end = index_pos + sizeof(index_entry);
+   boost::shared_lock<boost::shared_mutex> index_guard( _index_mutex );
+   mapping_ptr mapping = mapping_for( index_end, 0 );
+   if( mapping->index_size() < index_end )
+      return optional<index_entry>();
+
+   index_entry e;
+   std::memcpy( (char*)&e, mapping->index_data() + index_pos, sizeof(e) );
+   return e;
+}
+
+optional<signed_block> block_database::mapped_fetch( const index_entry& e )const
+{
+   if( e.block_size == 0 )
+      return optional<signed_block>();
+
+   const uint64_t blocks_end = e.block_pos + e.block_size;
+   mapping_ptr mapping = mapping_for( 0, blocks_end );
+   if( mapping->blocks_size() < blocks_end )
+      return optional<signed_block>();
+
+   fc::datastream<const char*> ds( mapping->blocks_data() + e.block_pos, e.block_size );
+   signed_block result;
+   fc::raw::unpack( ds, result );
+   FC_ASSERT( result.id() == e.block_id );
+   return result;
+}
+
+block_database::mapping_ptr block_database::mapping_for( uint64_t index_end, uint64_t blocks_end )const
+{
+   auto covers = [&]( const mapping_ptr& m ) {
+      return m && m->index_size() >= index_end && m->blocks_size() >= blocks_end;
+   };
+
+   mapping_ptr mapping = std::atomic_load( &_mapping );
+   if( covers( mapping ) )
+      return mapping;
+
+   std::lock_guard<std::mutex> guard( _remap_mutex );
+   mapping = std::atomic_load( &_mapping );
+   if( covers( mapping ) )
+      return mapping;
+   // If the files did not grow since the last mapping the requested range does not exist, keep the mapping we have.
+   if( mapping && fc::file_size( _index_filename ) == mapping->index_size()
+               && fc::file_size( _blocks_filename ) == mapping->blocks_size() )
+      return mapping;
+
+   auto fresh = std::make_shared<detail::block_database_mapping>();
+   detail::map_file( _index_filename, fresh->index_file, fresh->index_region );
+   detail::map_file( _blocks_filename, fresh->blocks_file, fresh->blocks_region );
+   mapping = fresh;
+   std::atomic_store( &_mapping, mapping );
+   return mapping;
+}
+
+void block_database::reset_mapping()const
+{
+   std::lock_guard<std::mutex> guard( _remap_mutex );
+   std::atomic_store( &_mapping, mapping_ptr() );
+}
+
+void block_database::truncate_index( uint64_t size )const
+{
+   // Index entries are only read from a mapping under a shared lock, so once this holds the lock exclusively no reader
+   // can touch the pages cut off the file, and the next one maps the truncated file.
+   boost::unique_lock<boost::shared_mutex> index_guard( _index_mutex );
+   reset_mapping();
+   fc::resize_file( _index_filename, size );
+}
+
 optional<signed_block> block_database::last()const
 {
    optional<index_entry> entry = last_index_entry();
@@ -24,6 +24,7 @@
 
 #include <graphene/chain/das33_evaluator.hpp>
 #include <graphene/chain/database.hpp>
+#include <graphene/chain/hardfork.hpp>
 #include <boost/multiprecision/cpp_int.hpp>
 #include <graphene/chain/market_object.hpp>
 
@@ -536,76 +537,33 @@ namespace graphene { namespace chain {
 
     auto& d = db();
 
-    std::vector<object_id_type> pledges_to_remove;
-    const auto& index = d.get_index_type<das33_pledge_holder_index>().indices().get<by_project>().equal_range(op.project);
-    auto itr = index.first;
-
-    while(itr != index.second)
+    das33_distribution_object distribution;
+       distribution.project_id = op.project;
+       distribution.phase_number = op.phase_number;
+       distribution.project_owner = _pro_owner;
+       distribution.to_escrow = op.to_escrow;
+       distribution.base_to_pledger = op.base_to_pledger;
+       distribution.bonus_to_pledger = op.bonus_to_pledger;
+       distribution.end_pledge = d.get_index<das33_pledge_holder_object>().get_next_id();
+
+    // Before the hardfork every pledge is distributed by the operation itself
+    uint32_t budget = (d.head_block_time() < HARDFORK_BLC_251_TIME) ? std::numeric_limits<uint32_t>::max()
+                                                                    : DAS33_DISTRIBUTION_BATCH_SIZE;
+    auto next = d.distribute_das33_pledges(distribution, budget);
+
+    // The rest is distributed at the end of the following blocks
+    if(next.valid())
     {
-       if(op.phase_number.valid() && itr->phase_number != *op.phase_number) {
-           ++itr;
-           continue;
-       }
-
-       const das33_pledge_holder_object& pho = *itr;
-
-       // calc amount of token and asset that will be exchanged
-       share_type base = std::round(static_cast<double>(pho.base_expected.amount.value) * op.base_to_pledger.value / BONUS_PRECISION / 100);
-                  base = (base < pho.base_remaining.amount) ? base : pho.base_remaining.amount;
-       share_type bonus = std::round(static_cast<double>(pho.bonus_expected.amount.value) * op.bonus_to_pledger.value / BONUS_PRECISION / 100);
-                  bonus = (bonus < pho.bonus_remaining.amount) ? bonus : pho.bonus_remaining.amount;
-       share_type pledge = std::round(static_cast<double>(pho.pledged.amount.value) * op.to_escrow.value / BONUS_PRECISION / 100);
-                  pledge = (pledge < pho.pledge_remaining.amount) ? pledge : pho.pledge_remaining.amount;
-
-       // make virtual op for history traking
-       das33_pledge_result_operation pledge_result;
-          pledge_result.funders_account = pho.account_id;
-          pledge_result.account_to_fund = _pro_owner;
-          pledge_result.completed = true;
-          pledge_result.pledged = pledge;
-          pledge_result.received = base + bonus;
-          pledge_result.project_id = op.project;
-          pledge_result.timestamp = d.head_block_time();
-       d.push_applied_operation(pledge_result);
-
-       d.adjust_balance(_pro_owner, asset{pledge, pho.pledged.asset_id}, 0 /*reserved_delta*/);
-
-       // issue balance object if it does not exists
-       if(!d.check_if_balance_object_exists(pho.account_id,pho.base_expected.asset_id))
-       {
-          d.create<account_balance_object>([&pho](account_balance_object& abo){
-             abo.owner = pho.account_id;
-             abo.asset_type = pho.base_expected.asset_id;
-             abo.balance = 0;
-             abo.reserved = 0;
-          });
-       }
-
-       // issue token asset
-       auto& balance1_obj = d.get_balance_object(pho.account_id, pho.base_expected.asset_id);
-       d.issue_asset(balance1_obj, base + bonus, 0);
-
-       // update pledge holder object
-       d.modify(pho, [&](das33_pledge_holder_object& p){
-          p.pledge_remaining.amount -= pledge;
-          p.base_remaining.amount -= base;
-          p.bonus_remaining.amount -= bonus;
+       d.create<das33_distribution_object>([&](das33_distribution_object& o){
+          o.project_id = distribution.project_id;
+          o.phase_number = distribution.phase_number;
+          o.project_owner = distribution.project_owner;
+          o.to_escrow = distribution.to_escrow;
+          o.base_to_pledger = distribution.base_to_pledger;
+          o.bonus_to_pledger = distribution.bonus_to_pledger;
+          o.next_pledge = *next;
+          o.end_pledge = distribution.end_pledge;
        });
-
-       // if everything is distributed remove object
-       if(pho.pledge_remaining.amount + pho.base_remaining.amount + pho.bonus_remaining.amount <= 0)
-       {
-          pledges_to_remove.push_back(pho.id);
-       }
-       itr++;
-    }
-
-    auto& index1 = d.get_index_type<das33_pledge_holder_index>().indices().get<by_id>();
-    for(object_id_type id : pledges_to_remove)
-    {
-       auto itr = index1.find(id);
-       if(itr != index1.end())
-          d.remove(*itr);
     }
 
     return {};
@@ -0,0 +1,149 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <graphene/chain/das33_object.hpp>
+
+namespace graphene { namespace chain {
+
+namespace {
+
+  void subtract_from( map<asset_id_type, share_type>& totals, const asset& amount )
+  {
+    auto itr = totals.find( amount.asset_id );
+    if( itr == totals.end() )
+      return;
+    itr->second -= amount.amount;
+    if( itr->second == 0 )
+      totals.erase( itr );
+  }
+
+  bool is_null_pledge( const das33_pledge_holder_object& pledge )
+  {
+    return pledge.id == object_id_type( das33_pledge_holder_id_type() );
+  }
+
+}
+
+const das33_pledge_totals_index::project_totals* das33_pledge_totals_index::find( das33_project_id_type project ) const
+{
+  auto itr = _totals.find( project );
+  return itr != _totals.end() ? &itr->second : nullptr;
+}
+
+const das33_pledge_totals_index::account_totals* das33_pledge_totals_index::find( account_id_type account ) const
+{
+  auto itr = _account_totals.find( account );
+  return itr != _account_totals.end() ? &itr->second : nullptr;
+}
+
+void das33_pledge_totals_index::add( const das33_pledge_holder_object& pledge )
+{
+  // The null pledge created at genesis is not counted
+  if( is_null_pledge( pledge ) )
+    return;
+  // Zero amounts are skipped here and in subtract, so the totals of an asset only go away with its last pledge
+  if( pledge.pledged.amount != 0 )
+  {
+    auto& totals = _totals[pledge.project_id];
+    totals.pledged[pledge.pledged.asset_id] += pledge.pledged.amount;
+    totals.pledged_by_phase[pledge.phase_number][pledge.pledged.asset_id] += pledge.pledged.amount;
+  }
+
+  auto& expected = _account_totals[pledge.account_id][pledge.project_id][pledge.phase_number];
+  expected.base += pledge.base_expected.amount;
+  expected.bonus += pledge.bonus_expected.amount;
+  ++expected.count;
+}
+
+void das33_pledge_totals_index::subtract( const das33_pledge_holder_object& pledge )
+{
+  if( is_null_pledge( pledge ) )
+    return;
+  if( pledge.pledged.amount != 0 )
+  {
+    auto itr = _totals.find( pledge.project_id );
+    assert( itr != _totals.end() );
+    if( itr != _totals.end() )
+    {
+      auto& totals = itr->second;
+      subtract_from( totals.pledged, pledge.pledged );
+      auto phase_itr = totals.pledged_by_phase.find( pledge.phase_number );
+      if( phase_itr != totals.pledged_by_phase.end() )
+      {
+        subtract_from( phase_itr->second, pledge.pledged );
+        if( phase_itr->second.empty() )
+          totals.pledged_by_phase.erase( phase_itr );
+      }
+      if( totals.pledged.empty() )
+        _totals.erase( itr );
+    }
+  }
+
+  auto account_itr = _account_totals.find( pledge.account_id );
+  if( account_itr == _account_totals.end() )
+    return;
+  auto project_itr = account_itr->second.find( pledge.project_id );
+  if( project_itr == account_itr->second.end() )
+    return;
+  auto expected_itr = project_itr->second.find( pledge.phase_number );
+  if( expected_itr == project_itr->second.end() )
+    return;
+  if( --expected_itr->second.count == 0 )
+  {
+    project_itr->second.erase( expected_itr );
+    if( project_itr->second.empty() )
+      account_itr->second.erase( project_itr );
+    if( account_itr->second.empty() )
+      _account_totals.erase( account_itr );
+    return;
+  }
+  expected_itr->second.base -= pledge.base_expected.amount;
+  expected_itr->second.bonus -= pledge.bonus_expected.amount;
+}
+
+void das33_pledge_totals_index::object_inserted( const object& obj )
+{
+  assert( dynamic_cast<const das33_pledge_holder_object*>(&obj) ); // for debug only
+  add( static_cast<const das33_pledge_holder_object&>(obj) );
+}
+
+void das33_pledge_totals_index::object_removed( const object& obj )
+{
+  assert( dynamic_cast<const das33_pledge_holder_object*>(&obj) ); // for debug only
+  subtract( static_cast<const das33_pledge_holder_object&>(obj) );
+}
+
+void das33_pledge_totals_index::about_to_modify( const object& before )
+{
+  assert( dynamic_cast<const das33_pledge_holder_object*>(&before) ); // for debug only
+  subtract( static_cast<const das33_pledge_holder_object&>(before) );
+}
+
+void das33_pledge_totals_index::object_modified( const object& after )
+{
+  assert( dynamic_cast<const das33_pledge_holder_object*>(&after) ); // for debug only
+  add( static_cast<const das33_pledge_holder_object&>(after) );
+}
+
+} } // graphene::chain
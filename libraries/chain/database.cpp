@@ -35,4 +35,5 @@
 #include "db_witness_schedule.cpp"
 #include "db_license.cpp"
 #include "db_queue.cpp"
+#include "db_das33.cpp"
 #include "db_util.cpp"
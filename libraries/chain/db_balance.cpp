@@ -174,13 +174,13 @@ void database::issue_asset(const account_balance_object& balance_obj, share_type
    if ( cash == 0 && reserved == 0 ) // allow issuing of reserved balance only
      return;
 
-   modify(balance_obj, [cash, reserved](account_balance_object& b) {
+   direct_modify<account_balance_index>(balance_obj, [cash, reserved](account_balance_object& b) {
       b.balance += cash;
       b.reserved += reserved;
    });
 
    const auto& asset_obj = balance_obj.asset_type(*this);
-   modify(asset_obj.dynamic_asset_data_id(*this), [&](asset_dynamic_data_object& data){
+   direct_modify<simple_index<asset_dynamic_data_object>>(asset_obj.dynamic_asset_data_id(*this), [&](asset_dynamic_data_object& data){
       data.current_supply += cash;
       data.current_supply += reserved;
    });
@@ -206,7 +206,7 @@ void database::adjust_balance(account_id_type account, asset delta, share_type r
                  ("a",account(*this).name)
                  ("b",to_pretty_string(asset(0,delta.asset_id)))
                  ("r",to_pretty_string(-asset(reserved_delta, delta.asset_id))));
-      create<account_balance_object>([account, &delta, reserved_delta](account_balance_object& b) {
+      direct_create<account_balance_index>([account, &delta, reserved_delta](account_balance_object& b) {
          b.owner = account;
          b.asset_type = delta.asset_id;
          b.balance = delta.amount.value;
@@ -227,7 +227,7 @@ void database::adjust_balance(account_id_type account, asset delta, share_type r
                     ("b",to_pretty_string(itr->get_reserved_balance()))
                     ("r",to_pretty_string(asset(-reserved_delta, delta.asset_id)))
                   );
-      modify(*itr, [delta, reserved_delta](account_balance_object& b) {
+      direct_modify<account_balance_index>(*itr, [delta, reserved_delta](account_balance_object& b) {
          b.adjust_balance(delta);
          b.reserved += reserved_delta;
       });
@@ -37,6 +37,11 @@
 #include <graphene/chain/evaluator.hpp>
 
 #include <fc/smart_ref_impl.hpp>
+#include <fc/thread/thread.hpp>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace graphene { namespace chain {
 
@@ -190,6 +195,7 @@ bool database::_push_block(const signed_block& new_block)
                    undo_database::session session = _undo_db.start_undo_session();
                    apply_block( (*ritr)->data, skip );
                    _block_id_to_block.store( (*ritr)->id, (*ritr)->data );
+                   _pending_tx_tracker.on_block_applied( _undo_db.head() );
                    session.commit();
                 }
                 catch ( const fc::exception& e ) { except = e; }
@@ -214,6 +220,7 @@ bool database::_push_block(const signed_block& new_block)
                       auto session = _undo_db.start_undo_session();
                       apply_block( (*ritr)->data, skip );
                       _block_id_to_block.store( new_block.id(), (*ritr)->data );
+                      _pending_tx_tracker.on_block_applied( _undo_db.head() );
                       session.commit();
                    }
                    throw *except;
@@ -229,6 +236,7 @@ bool database::_push_block(const signed_block& new_block)
       auto session = _undo_db.start_undo_session();
       apply_block(new_block, skip);
       _block_id_to_block.store(new_block.id(), new_block);
+      _pending_tx_tracker.on_block_applied( _undo_db.head() );
       session.commit();
    } catch ( const fc::exception& e ) {
       elog("Failed to push new block:\n${e}", ("e", e.to_detail_string()));
@@ -258,8 +266,12 @@ processed_transaction database::push_transaction( const signed_transaction& trx,
    return result;
 } FC_CAPTURE_AND_RETHROW( (trx) ) }
 
-processed_transaction database::_push_transaction( const signed_transaction& trx )
+processed_transaction database::_push_transaction( const signed_transaction& trx,
+                                                   pending_transaction_tracker::dependency_set* verified_authorities )
 {
+   // Throws if there is no room for the transaction in the pending pool
+   const optional<transaction_id_type> evicted_id = _pending_pool.admit( trx );
+
    // If this is the first transaction pushed after applying a block, start a new undo session.
    // This allows us to quickly rewind to the clean state of the head block, in case a new block arrives.
    if( !_pending_tx_session.valid() )
@@ -269,10 +281,27 @@ processed_transaction database::_push_transaction( const signed_transaction& trx
    // The temporary session will be discarded by the destructor if
    // _apply_transaction fails.  If we make it to merge(), we
    // apply the changes.
-
    auto temp_session = _undo_db.start_undo_session();
    auto processed_trx = _apply_transaction( trx );
+
+   // Nothing is evicted for a transaction which does not apply. The evicted transaction's changes stay in the
+   // pending state until the next block rebuilds it from the remaining pending transactions.
+   if( evicted_id.valid() )
+   {
+      auto itr = std::find_if( _pending_tx.begin(), _pending_tx.end(),
+                               [&]( const processed_transaction& tx ) { return tx.id() == *evicted_id; } );
+      if( itr != _pending_tx.end() )
+      {
+         wlog( "Evicted pending transaction ${id} to make room for ${t}", ("id", *evicted_id)("t", trx.id()) );
+         _pending_tx.erase( itr );
+      }
+      _pending_tx_tracker.erase( *evicted_id );
+      _pending_pool.evict( *evicted_id );
+   }
+
    _pending_tx.push_back(processed_trx);
+   _pending_tx_tracker.insert( trx.id(), std::move(verified_authorities ? *verified_authorities : _verified_authorities) );
+   _pending_pool.insert( trx );
 
    // notify_changed_objects();
 
@@ -284,6 +313,18 @@ processed_transaction database::_push_transaction( const signed_transaction& trx
    return processed_trx;
 }
 
+processed_transaction database::_push_verified_transaction( const signed_transaction& trx,
+                                                           pending_transaction_tracker::dependency_set&& dependencies )
+{
+   processed_transaction result;
+   detail::with_skip_flags( *this, get_node_properties().skip_flags | skip_transaction_signatures | skip_authority_check, [&]()
+   {
+      // The dependencies recorded when the transaction was verified are carried over:
+      result = _push_transaction( trx, &dependencies );
+   } );
+   return result;
+}
+
 processed_transaction database::validate_transaction( const signed_transaction& trx )
 {
    auto session = _undo_db.start_undo_session();
@@ -382,8 +423,9 @@ signed_block database::_generate_block(
 
    uint64_t postponed_tx_count = 0;
    // pop pending state (reset to head block state)
-   for( const processed_transaction& tx : _pending_tx )
+   for( size_t pending_index : _pending_pool.block_order( _pending_tx ) )
    {
+      const processed_transaction& tx = _pending_tx[pending_index];
       size_t new_total_size = total_block_size + fc::raw::pack_size( tx );
 
       // postpone transaction if it would make block too big
@@ -457,6 +499,7 @@ void database::pop_block()
 
    _fork_db.pop_block();
    pop_undo();
+   _pending_tx_tracker.on_block_popped();
 
    _popped_tx.insert( _popped_tx.begin(), head_block->transactions.begin(), head_block->transactions.end() );
 
@@ -466,6 +509,8 @@ void database::clear_pending()
 { try {
    assert( (_pending_tx.size() == 0) || _pending_tx_session.valid() );
    _pending_tx.clear();
+   _pending_tx_tracker.clear();
+   _pending_pool.clear();
    _pending_tx_session.reset();
 } FC_CAPTURE_AND_RETHROW() }
 
@@ -523,19 +568,9 @@ void database::applied_ops_to_virtual_ops( )
    {
       if(ooho.valid())
       {
-         operation_history_object& oho = *ooho;
-         if( operation_type_limits::is_virtual_operation(oho.op) )
-         {
-            vector<optional< operation_history_object > >::iterator it = std::find_if(_virtual_ops.begin(),_virtual_ops.end(),
-                  [&oho](optional<operation_history_object > const& e){
-                     return e->virtual_op == oho.virtual_op;
-            });
-
-            if(it == _virtual_ops.end())
-            {
-               _virtual_ops.push_back(ooho);
-            }
-         }
+         const operation_history_object& oho = *ooho;
+         if( operation_type_limits::is_virtual_operation(oho.op) && _virtual_op_numbers.insert(oho.virtual_op).second )
+            _virtual_ops.push_back(ooho);
       }
    }
 }
@@ -544,7 +579,8 @@ vector<optional< operation_history_object > > database::get_virtual_ops_and_clea
 {
    vector<optional< operation_history_object > > ret;
    std::swap(ret, _virtual_ops);
-   return std::move(ret);
+   _virtual_op_numbers.clear();
+   return ret;
 }
 
 void database::_apply_block( const signed_block& next_block )
@@ -564,6 +600,10 @@ void database::_apply_block( const signed_block& next_block )
    _current_block_num    = next_block_num;
    _current_trx_in_block = 0;
 
+   vector<optional<flat_set<public_key_type>>> signature_keys;
+   if( !(skip & (skip_transaction_signatures | skip_authority_check)) )
+      signature_keys = precompute_signature_keys( next_block );
+
    for( const auto& trx : next_block.transactions )
    {
       /* We do not need to push the undo state for each transaction
@@ -572,7 +612,10 @@ void database::_apply_block( const signed_block& next_block )
        * for transactions when validating broadcast transactions or
        * when building a block.
        */
-      apply_transaction( trx, skip | skip_transaction_signatures );
+      const flat_set<public_key_type>* trx_signature_keys = nullptr;
+      if( _current_trx_in_block < signature_keys.size() && signature_keys[_current_trx_in_block].valid() )
+         trx_signature_keys = &*signature_keys[_current_trx_in_block];
+      _apply_transaction( trx, trx_signature_keys );
       ++_current_trx_in_block;
    }
 
@@ -601,6 +644,8 @@ void database::_apply_block( const signed_block& next_block )
    update_witness_schedule();
 
    reset_spending_limits();
+   process_das33_distributions();
+   process_upgrade_events();
 
    if ( global_props.parameters.enable_dascoin_queue )
       mint_dascoin_rewards();
@@ -622,6 +667,55 @@ void database::_apply_block( const signed_block& next_block )
 
 } FC_CAPTURE_AND_RETHROW( (next_block.block_num()) )  }
 
+vector<optional<flat_set<public_key_type>>> database::precompute_signature_keys( const signed_block& next_block )
+{
+   const auto& trxs = next_block.transactions;
+   const chain_id_type& chain_id = get_chain_id();
+   vector<optional<flat_set<public_key_type>>> keys( trxs.size() );
+
+   if( _signature_threads.empty() )
+   {
+      const uint32_t count = _signature_thread_count ? _signature_thread_count : std::max( 1u, std::thread::hardware_concurrency() );
+      for( uint32_t i = 0; i < count; ++i )
+         _signature_threads.emplace_back( std::make_shared<fc::thread>( "signatures-" + fc::to_string( uint64_t(i) ) ) );
+   }
+
+   // With a single thread there is nothing to gain, the serial apply recovers the keys itself.
+   const size_t stride = std::min( _signature_threads.size(), trxs.size() );
+   if( stride <= 1 )
+      return keys;
+
+   // The caller is in the middle of applying a block, so it must not yield to other fibers of its thread while the
+   // keys are recovered. Wait on a plain condition variable rather than on fc futures.
+   std::mutex done_mutex;
+   std::condition_variable done_cv;
+   size_t running = stride;
+
+   // Failures are left for the serial apply, which recovers the keys again and reports the error in context.
+   auto recover = [&]( size_t first ) {
+      for( size_t i = first; i < trxs.size(); i += stride )
+      {
+         try
+         {
+            keys[i] = trxs[i].get_signature_keys( chain_id );
+         }
+         catch( ... )
+         {
+         }
+      }
+      std::lock_guard<std::mutex> guard( done_mutex );
+      if( --running == 0 )
+         done_cv.notify_one();
+   };
+
+   for( size_t t = 0; t < stride; ++t )
+      _signature_threads[t]->async( [&recover, t]() { recover( t ); }, "precompute_signature_keys" );
+
+   std::unique_lock<std::mutex> lock( done_mutex );
+   done_cv.wait( lock, [&running]() { return running == 0; } );
+   return keys;
+}
+
 processed_transaction database::apply_transaction(const signed_transaction& trx, uint32_t skip)
 {
    processed_transaction result;
@@ -632,7 +726,8 @@ processed_transaction database::apply_transaction(const signed_transaction& trx,
    return result;
 }
 
-processed_transaction database::_apply_transaction(const signed_transaction& trx)
+processed_transaction database::_apply_transaction( const signed_transaction& trx,
+                                                    const flat_set<public_key_type>* signature_keys )
 { try {
    uint32_t skip = get_node_properties().skip_flags;
 
@@ -648,11 +743,19 @@ processed_transaction database::_apply_transaction(const signed_transaction& trx
    const chain_parameters& chain_parameters = get_global_properties().parameters;
    eval_state._trx = &trx;
 
+   // Nothing is recorded when the verification is skipped, so no stale authorities of an earlier transaction remain:
+   _verified_authorities.clear();
    if( !(skip & (skip_transaction_signatures | skip_authority_check) ) )
    {
-      auto get_active = [&]( account_id_type id ) { return &id(*this).active; };
-      auto get_owner  = [&]( account_id_type id ) { return &id(*this).owner;  };
-      trx.verify_authority( chain_id, get_active, get_owner, get_global_properties().parameters.max_authority_depth );
+      // Record what the verification reads, so that a pending transaction is only verified again when it changes:
+      _verified_authorities.insert( global_property_id_type() );
+      auto get_active = [&]( account_id_type id ) { _verified_authorities.insert( id ); return &id(*this).active; };
+      auto get_owner  = [&]( account_id_type id ) { _verified_authorities.insert( id ); return &id(*this).owner;  };
+      const uint32_t max_authority_depth = get_global_properties().parameters.max_authority_depth;
+      if( signature_keys )
+         verify_authority( trx.operations, *signature_keys, get_active, get_owner, max_authority_depth );
+      else
+         trx.verify_authority( chain_id, get_active, get_owner, max_authority_depth );
    }
 
    //Skip all manner of expiration and TaPoS checking if we're on block 1; It's impossible that the transaction is
@@ -0,0 +1,128 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <graphene/chain/database.hpp>
+
+#include <graphene/chain/account_object.hpp>
+#include <graphene/chain/das33_object.hpp>
+
+#include <cmath>
+
+namespace graphene { namespace chain {
+
+namespace {
+
+  template<typename Iterator>
+  optional<das33_pledge_holder_id_type> distribute_pledge_range(database& d, const das33_distribution_object& distribution,
+                                                                Iterator itr, Iterator end, uint32_t& budget)
+  {
+    // Pledges are ordered by id within the range, so the ones made after the distribution was requested come last:
+    while ( itr != end && itr->id < object_id_type(distribution.end_pledge) )
+    {
+      if ( budget == 0 )
+        return das33_pledge_holder_id_type(itr->id);
+
+      // Advance first, the pledge is removed once it is fully distributed:
+      const das33_pledge_holder_object& pho = *itr++;
+      d.distribute_das33_pledge(pho, distribution);
+      --budget;
+    }
+    return {};
+  }
+
+}
+
+optional<das33_pledge_holder_id_type> database::distribute_das33_pledges(const das33_distribution_object& distribution,
+                                                                          uint32_t& budget)
+{
+  if ( distribution.phase_number.valid() )
+  {
+    const auto& idx = get_index_type<das33_pledge_holder_index>().indices().get<by_project_phase>();
+    return distribute_pledge_range(*this, distribution,
+                                   idx.lower_bound(boost::make_tuple(distribution.project_id, *distribution.phase_number,
+                                                                     object_id_type(distribution.next_pledge))),
+                                   idx.upper_bound(boost::make_tuple(distribution.project_id, *distribution.phase_number)),
+                                   budget);
+  }
+
+  const auto& idx = get_index_type<das33_pledge_holder_index>().indices().get<by_project>();
+  return distribute_pledge_range(*this, distribution,
+                                 idx.lower_bound(boost::make_tuple(distribution.project_id,
+                                                                   object_id_type(distribution.next_pledge))),
+                                 idx.upper_bound(boost::make_tuple(distribution.project_id)),
+                                 budget);
+}
+
+void database::distribute_das33_pledge(const das33_pledge_holder_object& pho,
+                                       const das33_distribution_object& distribution)
+{
+  // calc amount of token and asset that will be exchanged
+  share_type base = std::round(static_cast<double>(pho.base_expected.amount.value) * distribution.base_to_pledger.value / BONUS_PRECISION / 100);
+             base = (base < pho.base_remaining.amount) ? base : pho.base_remaining.amount;
+  share_type bonus = std::round(static_cast<double>(pho.bonus_expected.amount.value) * distribution.bonus_to_pledger.value / BONUS_PRECISION / 100);
+             bonus = (bonus < pho.bonus_remaining.amount) ? bonus : pho.bonus_remaining.amount;
+  share_type pledge = std::round(static_cast<double>(pho.pledged.amount.value) * distribution.to_escrow.value / BONUS_PRECISION / 100);
+             pledge = (pledge < pho.pledge_remaining.amount) ? pledge : pho.pledge_remaining.amount;
+
+  // make virtual op for history traking
+  das33_pledge_result_operation pledge_result;
+     pledge_result.funders_account = pho.account_id;
+     pledge_result.account_to_fund = distribution.project_owner;
+     pledge_result.completed = true;
+     pledge_result.pledged = pledge;
+     pledge_result.received = base + bonus;
+     pledge_result.project_id = distribution.project_id;
+     pledge_result.timestamp = head_block_time();
+  push_applied_operation(pledge_result);
+
+  adjust_balance(distribution.project_owner, asset{pledge, pho.pledged.asset_id}, 0 /*reserved_delta*/);
+
+  // issue balance object if it does not exists
+  if(!check_if_balance_object_exists(pho.account_id, pho.base_expected.asset_id))
+  {
+     create<account_balance_object>([&pho](account_balance_object& abo){
+        abo.owner = pho.account_id;
+        abo.asset_type = pho.base_expected.asset_id;
+        abo.balance = 0;
+        abo.reserved = 0;
+     });
+  }
+
+  // issue token asset
+  auto& balance_obj = get_balance_object(pho.account_id, pho.base_expected.asset_id);
+  issue_asset(balance_obj, base + bonus, 0);
+
+  // update pledge holder object
+  modify(pho, [&](das33_pledge_holder_object& p){
+     p.pledge_remaining.amount -= pledge;
+     p.base_remaining.amount -= base;
+     p.bonus_remaining.amount -= bonus;
+  });
+
+  // if everything is distributed remove object
+  if(pho.pledge_remaining.amount + pho.base_remaining.amount + pho.bonus_remaining.amount <= 0)
+     remove(pho);
+}
+
+} }  // namespace graphene::chain
@@ -317,7 +317,8 @@ void database::initialize_indexes()
 
    add_index< primary_index<committee_member_index> >();
    add_index< primary_index<witness_index> >();
-   add_index< primary_index<limit_order_index > >();
+   auto limit_order_idx = add_index< primary_index<limit_order_index > >();
+   limit_order_idx->add_secondary_index<limit_order_price_level_index>();
    add_index< primary_index<last_price_index > >();
    add_index< primary_index<external_price_index > >();
    add_index< primary_index<call_order_index > >();
@@ -333,7 +334,9 @@ void database::initialize_indexes()
 
    //Implementation object indexes
    add_index< primary_index<transaction_index                             > >();
-   add_index< primary_index<account_balance_index                         > >();
+   auto balance_index = add_index< primary_index<account_balance_index    > >();
+   acnt_index->add_secondary_index<dasc_holder_account_index>()->holders =
+      balance_index->add_secondary_index<dasc_holder_index>();
    add_index< primary_index<asset_bitasset_data_index                     > >();
    add_index< primary_index<simple_index<global_property_object          >> >();
    add_index< primary_index<simple_index<dynamic_global_property_object  >> >();
@@ -354,7 +357,8 @@ void database::initialize_indexes()
    add_index<primary_index<issue_asset_request_index>>();
    add_index<primary_index<wire_out_holder_index>>();
    add_index<primary_index<reward_queue_index>>();
-   add_index<primary_index<license_information_index>>();
+   auto license_information_idx = add_index<primary_index<license_information_index>>();
+   license_information_idx->add_secondary_index<license_totals_index>();
    add_index<primary_index<issued_asset_record_index>>();
    add_index<primary_index<frequency_history_record_index>>();
    add_index<primary_index<witness_delegate_data_index > >();
@@ -362,7 +366,9 @@ void database::initialize_indexes()
    add_index<primary_index<daspay_authority_index>>();
    add_index<primary_index<payment_service_provider_index>>();
    add_index<primary_index<das33_project_index>>();
-   add_index<primary_index<das33_pledge_holder_index>>();
+   auto das33_pledge_idx = add_index<primary_index<das33_pledge_holder_index>>();
+   das33_pledge_idx->add_secondary_index<das33_pledge_totals_index>();
+   add_index<primary_index<das33_distribution_index>>();
    add_index<primary_index<delayed_operations_index>>();
 }
 
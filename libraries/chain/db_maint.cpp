@@ -39,6 +39,7 @@
 #include <graphene/chain/committee_member_object.hpp>
 #include <graphene/chain/fba_object.hpp>
 #include <graphene/chain/global_property_object.hpp>
+#include <graphene/chain/license_objects.hpp>
 #include <graphene/chain/market_object.hpp>
 #include <graphene/chain/special_authority_object.hpp>
 #include <graphene/chain/upgrade_event_object.hpp>
@@ -772,14 +773,10 @@ void database::perform_upgrades(const account_object& account, const upgrade_eve
                   if (lio.vault_license_kind == chartered || lio.vault_license_kind == utility)
                   {
                      auto origin = fc::reflector<dascoin_origin_kind>::to_string(dascoin_origin_kind::reserve_cycles);
-                     std::ostringstream comment;
-                     comment << "Licence "
-                             << license_id_to_string(license_history.base_amount)
-                             << " Upgrade "
-                             << (int) license_history.balance_upgrade.used
-                             << "/"
-                             << (int) license_history.balance_upgrade.max;
-                     push_queue_submission(origin, license_history.license, account.id, amount, license_history.frequency_lock, comment.str());
+                     string comment = "Licence " + license_id_to_string(license_history.base_amount)
+                                    + " Upgrade " + std::to_string(static_cast<int>(license_history.balance_upgrade.used))
+                                    + "/" + std::to_string(static_cast<int>(license_history.balance_upgrade.max));
+                     push_queue_submission(origin, license_history.license, account.id, amount, license_history.frequency_lock, comment);
                      push_applied_operation(
                           record_submit_charter_license_cycles_operation(get_chain_authorities().license_issuer, account.id, amount, license_history.frequency_lock)
                      );
@@ -855,11 +852,54 @@ void database::perform_upgrades()
       });
 
       last_upgrade = *it;
-      perform_upgrades_helper upgrades_helper(*this, *it);
-      perform_helpers<account_index, by_name>(std::tie(upgrades_helper));
+      if ( head_block_time() < HARDFORK_BLC_258_TIME )
+      {
+         perform_upgrades_helper upgrades_helper(*this, *it);
+         perform_helpers<account_index, by_name>(std::tie(upgrades_helper));
+      }
+      else
+      {
+         // Only licensed vaults are visited, in batches continued by process_upgrade_events.
+         // An execution which is still in progress is restarted:
+         modify(*it, [](upgrade_event_object& obj){
+            obj.cursor = account_id_type();
+         });
+      }
    }
 }
 
+optional<account_id_type> database::continue_upgrade_event(const upgrade_event_object& upgrade, uint32_t& budget)
+{
+   // Each licensed vault has exactly one license information object:
+   const auto& idx = get_index_type<license_information_index>().indices().get<by_account_id>();
+   auto itr = idx.lower_bound(boost::make_tuple(*upgrade.cursor));
+
+   for ( ; itr != idx.end() && budget > 0; ++itr, --budget )
+      perform_upgrades(itr->account(*this), upgrade);
+
+   if ( itr == idx.end() )
+      return {};
+   return itr->account;
+}
+
+void database::process_upgrade_events()
+{ try {
+   uint32_t budget = _upgrade_batch_size;
+   const auto& idx = get_index_type<upgrade_event_index>().indices().get<by_id>();
+
+   // Upgrade events in progress are continued in the order they were created, sharing the budget of the block:
+   for ( auto it = idx.cbegin(); it != idx.cend() && budget > 0; ++it )
+   {
+      if ( !it->cursor.valid() )
+         continue;
+
+      auto next = continue_upgrade_event(*it, budget);
+      modify(*it, [&](upgrade_event_object& obj){
+         obj.cursor = next;
+      });
+   }
+} FC_CAPTURE_AND_RETHROW() }
+
 void database::perform_chain_maintenance(const signed_block& next_block, const global_property_object& global_props)
 {
    const auto& gpo = get_global_properties();
@@ -29,12 +29,164 @@
 
 #include <fc/io/fstream.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <exception>
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
 
 namespace graphene { namespace chain {
 
+namespace detail {
+
+   /**
+    * Restores the block database read path when the replay ends, also when it ends with an exception.
+    */
+   struct mmap_reads_restorer
+   {
+      mmap_reads_restorer( block_database& blocks, bool old_mmap_reads )
+         : _blocks( blocks ), _old_mmap_reads( old_mmap_reads )
+      {}
+
+      ~mmap_reads_restorer()
+      {
+         _blocks.set_mmap_reads( _old_mmap_reads );
+      }
+
+      block_database& _blocks;
+      bool _old_mmap_reads;
+   };
+
+   /**
+    * Reads blocks ahead of the replay on a pool of worker threads. Each worker fetches and unpacks a block from the
+    * block database (which checks the block id) and verifies its transaction merkle root. Prepared blocks are handed
+    * to the applying thread in block number order, and at most @ref capacity blocks are held in memory at a time.
+    */
+   class replay_pipeline
+   {
+      public:
+         struct item
+         {
+            optional<signed_block> block;
+            bool                   merkle_verified = false;
+            std::exception_ptr     error;   ///< Set when preparing the block failed, rethrown by next()
+         };
+
+         replay_pipeline( const block_database& blocks, uint32_t first, uint32_t last, uint32_t threads, uint32_t capacity )
+            : _blocks( blocks ), _last( last ), _capacity( capacity ), _next_fetch( first ), _next_apply( first )
+         {
+            for( uint32_t i = 0; i < threads; ++i )
+               _workers.emplace_back( [this]{ work(); } );
+         }
+
+         ~replay_pipeline()
+         {
+            {
+               std::lock_guard<std::mutex> guard( _mutex );
+               _stop = true;
+            }
+            _space.notify_all();
+            for( auto& worker : _workers )
+               worker.join();
+         }
+
+         /// Blocks until block number @ref block_num is prepared, block numbers must be requested in order.
+         item next( uint32_t block_num )
+         {
+            const auto start = fc::time_point::now();
+            item result;
+            {
+               std::unique_lock<std::mutex> lock( _mutex );
+               _ready_cv.wait( lock, [&]{ return _ready.count( block_num ) > 0; } );
+               result = std::move( _ready[block_num] );
+               _ready.erase( block_num );
+               _next_apply = block_num + 1;
+            }
+            _space.notify_all();
+            _wait_time += ( fc::time_point::now() - start ).count();
+            if( result.error )
+               std::rethrow_exception( result.error );
+            return result;
+         }
+
+         int64_t  fetch_time()const { return _fetch_time; }
+         int64_t  merkle_time()const { return _merkle_time; }
+         int64_t  wait_time()const { return _wait_time; }
+
+      private:
+         void work()
+         {
+            while( true )
+            {
+               uint32_t block_num;
+               {
+                  std::unique_lock<std::mutex> lock( _mutex );
+                  _space.wait( lock, [&]{ return _stop || _next_fetch < _next_apply + _capacity; } );
+                  if( _stop || _next_fetch > _last )
+                     return;
+                  block_num = _next_fetch++;
+               }
+
+               item prepared;
+               auto start = fc::time_point::now();
+               auto fetched = start;
+               // An exception escaping a std::thread terminates the process, hand it over to the applying thread instead.
+               try
+               {
+                  prepared.block = _blocks.fetch_by_number( block_num );
+                  fetched = fc::time_point::now();
+                  try
+                  {
+                     if( prepared.block.valid() )
+                        prepared.merkle_verified = prepared.block->transaction_merkle_root == prepared.block->calculate_merkle_root();
+                  }
+                  catch( const fc::exception& )
+                  {
+                     // Leave the merkle check to apply_block, which reports the failure.
+                  }
+               }
+               catch( ... )
+               {
+                  prepared.block.reset();
+                  prepared.error = std::current_exception();
+                  fetched = fc::time_point::now();
+               }
+               _fetch_time += ( fetched - start ).count();
+               _merkle_time += ( fc::time_point::now() - fetched ).count();
+
+               {
+                  std::lock_guard<std::mutex> guard( _mutex );
+                  _ready[block_num] = std::move( prepared );
+               }
+               _ready_cv.notify_all();
+            }
+         }
+
+         const block_database&    _blocks;
+         const uint32_t           _last;
+         const uint32_t           _capacity;
+
+         std::mutex               _mutex;
+         std::condition_variable  _space;
+         std::condition_variable  _ready_cv;
+         std::map<uint32_t, item> _ready;
+         uint32_t                 _next_fetch;
+         uint32_t                 _next_apply;
+         bool                     _stop = false;
+
+         std::atomic<int64_t>     _fetch_time{0};
+         std::atomic<int64_t>     _merkle_time{0};
+         std::atomic<int64_t>     _wait_time{0};
+
+         std::vector<std::thread> _workers;
+   };
+
+} // graphene::chain::detail
+
 database::database()
 {
    initialize_indexes();
@@ -71,6 +223,25 @@ void database::reindex(fc::path data_dir)
    }
    else
       _undo_db.disable();
+
+   // Workers read the block database concurrently with the replay, which is only safe through the mapped read path.
+   // The pipeline is declared after the restorer, so its workers are joined before the read path is switched back.
+   detail::mmap_reads_restorer restore_mmap_reads( _block_id_to_block, _block_id_to_block.mmap_reads() );
+   std::unique_ptr<detail::replay_pipeline> pipeline;
+   if( _replay_threads > 0 )
+   {
+      if( !restore_mmap_reads._old_mmap_reads )
+      {
+         _block_id_to_block.flush();
+         _block_id_to_block.set_mmap_reads( true );
+      }
+      ilog( "Using ${n} threads to prepare blocks for replay", ("n", _replay_threads) );
+      pipeline.reset( new detail::replay_pipeline( _block_id_to_block, head_block_num() + 1, last_block_num,
+                                                   _replay_threads, GRAPHENE_REPLAY_PIPELINE_CAPACITY ) );
+   }
+   const uint32_t first_block_num = head_block_num() + 1;
+   int64_t apply_time = 0;
+
    for( uint32_t i = head_block_num() + 1; i <= last_block_num; ++i )
    {
       if( i % 10000 == 0 ) std::cerr << "   " << double(i*100)/last_block_num << "%   "<<i << " of " <<last_block_num<<"   \n";
@@ -80,10 +251,26 @@ void database::reindex(fc::path data_dir)
          flush();
          ilog( "Done" );
       }
-      fc::optional< signed_block > block = _block_id_to_block.fetch_by_number(i);
+      uint32_t skip = skip_witness_signature |
+                      skip_transaction_signatures |
+                      skip_transaction_dupe_check |
+                      skip_tapos_check |
+                      skip_witness_schedule_check |
+                      skip_authority_check;
+      fc::optional< signed_block > block;
+      if( pipeline )
+      {
+         auto prepared = pipeline->next( i );
+         block = std::move( prepared.block );
+         if( prepared.merkle_verified )
+            skip |= skip_merkle_check;
+      }
+      else
+         block = _block_id_to_block.fetch_by_number(i);
       if( !block.valid() )
       {
          wlog( "Reindexing terminated due to gap:  Block ${i} does not exist!", ("i", i) );
+         pipeline.reset();
          uint32_t dropped_count = 0;
          while( true )
          {
@@ -103,29 +290,40 @@ void database::reindex(fc::path data_dir)
          wlog( "Dropped ${n} blocks from after the gap", ("n", dropped_count) );
          break;
       }
+      auto apply_start = fc::time_point::now();
       if( i < undo_point )
-         apply_block(*block, skip_witness_signature |
-                             skip_transaction_signatures |
-                             skip_transaction_dupe_check |
-                             skip_tapos_check |
-                             skip_witness_schedule_check |
-                             skip_authority_check);
+         apply_block(*block, skip);
       else
       {
          _undo_db.enable();
-         push_block(*block, skip_witness_signature |
-                            skip_transaction_signatures |
-                            skip_transaction_dupe_check |
-                            skip_tapos_check |
-                            skip_witness_schedule_check |
-                            skip_authority_check);
+         push_block(*block, skip);
       }
+      apply_time += ( fc::time_point::now() - apply_start ).count();
    }
    _undo_db.enable();
    auto end = fc::time_point::now();
    ilog( "Done reindexing, elapsed time: ${t} sec", ("t",double((end-start).count())/1000000.0 ) );
+
+   // Blocks per second of busy time for each stage, the worker stages are summed over all workers:
+   const uint32_t replayed = head_block_num() >= first_block_num ? head_block_num() - first_block_num + 1 : 0;
+   auto rate = [replayed]( int64_t usec ) { return usec > 0 ? double(replayed) * 1000000.0 / usec : 0.0; };
+   if( pipeline )
+   {
+      ilog( "Replay stages (${n} blocks): fetch ${f} blocks/s/thread, merkle ${m} blocks/s/thread, "
+            "apply ${a} blocks/s, apply thread waited ${w} sec on workers",
+            ("n", replayed)("f", rate(pipeline->fetch_time()))("m", rate(pipeline->merkle_time()))
+            ("a", rate(apply_time))("w", double(pipeline->wait_time())/1000000.0) );
+   }
+   else
+      ilog( "Replay stages (${n} blocks): apply ${a} blocks/s", ("n", replayed)("a", rate(apply_time)) );
 } FC_CAPTURE_AND_RETHROW( (data_dir) ) }
 
+void database::flush()
+{
+   flushing();
+   object_database::flush();
+}
+
 void database::wipe(const fc::path& data_dir, bool include_blocks)
 {
    ilog("Wiping database", ("include_blocks", include_blocks));
@@ -211,7 +409,7 @@ void database::close(bool rewind)
    // DB state (issue #336).
    clear_pending();
 
-   object_database::flush();
+   flush();
    object_database::close();
 
    if( _block_id_to_block.is_open() )
@@ -775,6 +775,8 @@ void get_relevant_accounts( const object* obj, flat_set<account_id_type>& accoun
               break;
             case impl_delayed_operation_object_type:
               break;
+            case impl_das33_distribution_object_type:
+              break;
       }
    }
 }
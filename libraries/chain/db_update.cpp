@@ -26,6 +26,7 @@
 #include <graphene/chain/db_with.hpp>
 
 #include <graphene/chain/asset_object.hpp>
+#include <graphene/chain/das33_object.hpp>
 #include <graphene/chain/global_property_object.hpp>
 #include <graphene/chain/hardfork.hpp>
 #include <graphene/chain/license_objects.hpp>
@@ -510,16 +511,19 @@ void database::reset_spending_limits()
 
   if ( dgpo.next_spend_limit_reset <= head_block_time() )
   {
-    // Reset spending limit for each account:
-    const auto& account_idx = get_index_type<account_index>().indices().get<by_id>();
-    for ( const auto& account : account_idx )
+    if ( head_block_time() < HARDFORK_BLC_238_TIME )
     {
-      // TODO: price should be a weekly average price, not the last price at the moment of sampling.
-      auto dsc_limit = get_dascoin_limit(account, dgpo.last_dascoin_price);
-      if ( dsc_limit.valid() )
+      // Reset spending limit for each account:
+      const auto& account_idx = get_index_type<account_index>().indices().get<by_id>();
+      for ( const auto& account : account_idx )
       {
-        // Set the limit on the account balance object:
-        adjust_balance_limit(account, get_dascoin_asset_id(), *dsc_limit, true);
+        // TODO: price should be a weekly average price, not the last price at the moment of sampling.
+        auto dsc_limit = get_dascoin_limit(account, dgpo.last_dascoin_price);
+        if ( dsc_limit.valid() )
+        {
+          // Set the limit on the account balance object:
+          adjust_balance_limit(account, get_dascoin_asset_id(), *dsc_limit, true);
+        }
       }
     }
 
@@ -534,11 +538,54 @@ void database::reset_spending_limits()
         dgpo.next_spend_limit_reset = fc::time_point_sec(next_interval) + params.limit_interval_elapse_time_seconds;
       else
         dgpo.next_spend_limit_reset = fc::time_point_sec(next_interval);
+      // Start a new sweep over all vaults, restarting one which is still in progress:
+      if ( head_block_time() >= HARDFORK_BLC_238_TIME )
+        dgpo.spend_limit_reset_cursor = account_id_type();
+    });
+  }
+
+  if ( dgpo.spend_limit_reset_cursor.valid() )
+  {
+    // Only vaults have a dascoin limit, so wallets are never visited. The limit is calculated from the price
+    // sampled when the reset started, so every batch of the same sweep uses the same price:
+    const auto& kind_idx = get_index_type<account_index>().indices().get<by_kind>();
+    auto itr = kind_idx.lower_bound(boost::make_tuple(account_kind::vault, object_id_type(*dgpo.spend_limit_reset_cursor)));
+    const auto end = kind_idx.upper_bound(boost::make_tuple(account_kind::vault));
+
+    for ( uint32_t processed = 0; itr != end && processed < _spend_limit_reset_batch_size; ++itr, ++processed )
+    {
+      auto dsc_limit = get_dascoin_limit(*itr, dgpo.last_daily_dascoin_price);
+      if ( dsc_limit.valid() )
+        adjust_balance_limit(*itr, get_dascoin_asset_id(), *dsc_limit, true);
+    }
+
+    modify(dgpo, [&](dynamic_global_property_object& dgpo){
+      if ( itr == end )
+        dgpo.spend_limit_reset_cursor.reset();
+      else
+        dgpo.spend_limit_reset_cursor = itr->get_id();
     });
   }
 
 } FC_CAPTURE_AND_RETHROW() }
 
+void database::process_das33_distributions()
+{ try {
+  uint32_t budget = DAS33_DISTRIBUTION_BATCH_SIZE;
+  const auto& idx = get_index_type<das33_distribution_index>().indices().get<by_id>();
+
+  // Distributions are continued in the order they were requested, sharing the budget of the block:
+  while ( !idx.empty() && budget > 0 )
+  {
+    const auto& distribution = *idx.begin();
+    auto next = distribute_das33_pledges(distribution, budget);
+    if ( next.valid() )
+      modify(distribution, [&](das33_distribution_object& o){ o.next_pledge = *next; });
+    else
+      remove(distribution);
+  }
+} FC_CAPTURE_AND_RETHROW() }
+
 void database::mint_dascoin_rewards()
 { try {
   const auto& params = get_global_properties().parameters;
@@ -716,14 +763,19 @@ void database::resolve_delayed_operations()
   if ( dgpo.next_delayed_operations_resolver_time > head_block_time() )
     return;
 
-  const auto& idx = get_index_type<delayed_operations_index>().indices().get<by_account>();
-  for (auto it = idx.cbegin(); it != idx.cend(); ++it)
+  // Only the expired prefix of the due time index is visited:
+  const auto& idx = get_index_type<delayed_operations_index>().indices().get<by_due_time>();
+  vector<std::reference_wrapper<const delayed_operation_object>> due(idx.begin(), idx.upper_bound(boost::make_tuple(head_block_time())));
+
+  // Resolve in account order, as before the due time index existed, so the emitted operations stay the same:
+  std::sort(due.begin(), due.end(), [](const delayed_operation_object& a, const delayed_operation_object& b) {
+    return std::tie(a.account, a.id) < std::tie(b.account, b.id);
+  });
+
+  for (const delayed_operation_object& dop : due)
   {
-    if (it->issued_time + it->skip <= head_block_time())
-    {
-      it->op.visit(op_visitor(*this));
-      remove(*it);
-    }
+    dop.op.visit(op_visitor(*this));
+    remove(dop);
   }
 
   modify(dgpo, [&](dynamic_global_property_object& dgpo){
@@ -32,8 +32,7 @@ namespace graphene { namespace chain {
 
 share_type database::cycles_to_dascoin(share_type cycles, share_type frequency) const
 {
-  FC_ASSERT( frequency != 0 );
-  return (cycles * DASCOIN_DEFAULT_ASSET_PRECISION * DASCOIN_FREQUENCY_PRECISION) / frequency;
+  return graphene::chain::cycles_to_dascoin(cycles, frequency);
 }
 
 share_type database::dascoin_to_cycles(share_type dascoin, share_type frequency) const
@@ -368,6 +368,20 @@ class database_access_layer {
         return vector<typename IndexType::object_type>(start, end);
     }
 
+    // Same as get_range, but for ranked indices, where the page start is found in logarithmic time.
+    template <typename IndexType, typename IndexBy, int MAX_ELEMENTS = 100>
+    vector<typename IndexType::object_type> get_ranked_range(uint32_t from, uint32_t amount) const
+    {
+        const auto& idx = _db.get_index_type<IndexType>().indices().get<IndexBy>();
+        FC_ASSERT(idx.size() > from, "Index out of bounds, index: ${from}, size: ${size}", ("from", from)("size", idx.size()));
+        FC_ASSERT(idx.size() - from >= amount, "Index out of bounds, amount: ${amount}, size: ${size}", ("amount", amount)("size", idx.size()));
+        FC_ASSERT(amount <= MAX_ELEMENTS, "Cannot retrieve more than ${max} elements in one page", ("max", MAX_ELEMENTS));
+        auto start = idx.nth(from);
+        auto end = start;
+        std::advance(end, amount);
+        return vector<typename IndexType::object_type>(start, end);
+    }
+
     template <typename ReturnType>
     vector<ReturnType> get_balance(const vector<account_id_type>& ids, const std::function<ReturnType(account_id_type)>& getter) const
     {
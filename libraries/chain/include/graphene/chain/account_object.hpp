@@ -448,6 +448,74 @@ namespace graphene { namespace chain {
          map< account_id_type, set<account_id_type> > referred_by;
    };
 
+   /**
+    *  @brief This secondary index ranks the DASC holders: wallets together with the vaults tethered to them,
+    *  custodians and untethered vaults. It is attached to the account balance index and learns about the accounts
+    *  through a dasc_holder_account_index, so objects may arrive in any order.
+    */
+   class dasc_holder_index : public secondary_index
+   {
+      public:
+         struct holder
+         {
+            account_id_type id;
+            uint32_t        vaults = 0;
+            share_type      amount;
+         };
+         /** largest amount first, ties by account id */
+         struct by_amount
+         {
+            bool operator()( const holder& a, const holder& b )const
+            {
+               return a.amount != b.amount ? a.amount > b.amount : a.id < b.id;
+            }
+         };
+         typedef std::set< holder, by_amount > ranking_type;
+
+         virtual void object_inserted( const object& obj ) override;
+         virtual void object_removed( const object& obj ) override;
+         virtual void about_to_modify( const object& before ) override;
+         virtual void object_modified( const object& after  ) override;
+
+         void account_changed( const account_object& a );
+         void account_removed( const account_object& a );
+
+         const ranking_type& ranking()const { return _ranking; }
+
+      private:
+         struct account_info
+         {
+            optional<account_kind>    kind;
+            flat_set<account_id_type> parents;
+            flat_set<account_id_type> vaults;
+            share_type                balance;
+            share_type                reserved;
+         };
+
+         void set_balance( const account_balance_object& b, share_type balance, share_type reserved );
+         /** recalculates the holding of an account and of the wallets it is tethered to */
+         void update( account_id_type id, const flat_set<account_id_type>& old_parents );
+         void update_holder( account_id_type id );
+
+         map< account_id_type, account_info >                 _accounts;
+         map< account_id_type, ranking_type::const_iterator > _holders;
+         ranking_type                                         _ranking;
+   };
+
+   /**
+    *  @brief Feeds the account changes to a dasc_holder_index.
+    */
+   class dasc_holder_account_index : public secondary_index
+   {
+      public:
+         virtual void object_inserted( const object& obj ) override;
+         virtual void object_removed( const object& obj ) override;
+         virtual void about_to_modify( const object& before ) override;
+         virtual void object_modified( const object& after  ) override;
+
+         dasc_holder_index* holders = nullptr;
+   };
+
    struct by_account_asset;
    struct by_asset_balance;
    /**
@@ -486,6 +554,7 @@ namespace graphene { namespace chain {
    typedef generic_index<account_balance_object, account_balance_object_multi_index_type> account_balance_index;
 
    struct by_name;
+   struct by_kind;
    typedef multi_index_container<
       account_object,
       indexed_by<
@@ -494,6 +563,12 @@ namespace graphene { namespace chain {
          >,
          ordered_unique< tag<by_name>,
             member<account_object, string, &account_object::name>
+         >,
+         ordered_unique< tag<by_kind>,
+            composite_key< account_object,
+               member<account_object, account_kind, &account_object::kind>,
+               member<object, object_id_type, &object::id>
+            >
          >
       >
    > account_multi_index_type;
@@ -23,10 +23,15 @@
  */
 #pragma once
 #include <fstream>
+#include <memory>
+#include <mutex>
 #include <graphene/chain/protocol/block.hpp>
 
+#include <boost/thread/shared_mutex.hpp>
+
 namespace graphene { namespace chain {
    class index_entry;
+   namespace detail { struct block_database_mapping; }
 
    class block_database
    {
@@ -45,10 +50,35 @@ namespace graphene { namespace chain {
          optional<signed_block> fetch_by_number( uint32_t block_num )const;
          optional<signed_block> last()const;
          optional<block_id_type> last_id()const;
+
+         /**
+          * When enabled, contains() and the fetch methods read the index and blocks files through read-only memory
+          * mappings instead of the shared fstreams, so they can be called concurrently from several threads while
+          * blocks are being stored. The mappings are replaced as the files grow. Must be set before open(), or right
+          * after flush().
+          */
+         void set_mmap_reads( bool enable ) { _mmap_reads = enable; }
+         bool mmap_reads()const { return _mmap_reads; }
       private:
+         typedef std::shared_ptr<const detail::block_database_mapping> mapping_ptr;
+
          optional<index_entry> last_index_entry()const;
+         optional<index_entry> mapped_index_entry( uint32_t block_num )const;
+         optional<signed_block> mapped_fetch( const index_entry& e )const;
+         mapping_ptr mapping_for( uint64_t index_end, uint64_t blocks_end )const;
+         void reset_mapping()const;
+         void truncate_index( uint64_t size )const;
+
          fc::path _index_filename;
+         fc::path _blocks_filename;
          mutable std::fstream _blocks;
          mutable std::fstream _block_num_to_pos;
+
+         bool                _mmap_reads = false;
+         mutable mapping_ptr _mapping;
+         mutable std::mutex  _remap_mutex;
+         /// Held shared while an index entry is read from a mapping, and exclusively while the index file is written or
+         /// truncated, so mapped readers never see a partly written entry or a page cut off the file
+         mutable boost::shared_mutex _index_mutex;
    };
 } }
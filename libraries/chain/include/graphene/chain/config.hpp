@@ -52,6 +52,7 @@
 
 #define GRAPHENE_MIN_UNDO_HISTORY 10
 #define GRAPHENE_MAX_UNDO_HISTORY 10000
+#define GRAPHENE_REPLAY_PIPELINE_CAPACITY 1024 ///< max number of blocks prepared ahead of the replay
 
 #define GRAPHENE_MIN_BLOCK_SIZE_LIMIT (GRAPHENE_MIN_TRANSACTION_SIZE_LIMIT*5) // 5 transactions per block
 #define GRAPHENE_MIN_TRANSACTION_EXPIRATION_LIMIT (GRAPHENE_MAX_BLOCK_INTERVAL * 5) // 5 transactions per block
@@ -144,7 +145,7 @@
 #define GRAPHENE_RECENTLY_MISSED_COUNT_INCREMENT             4
 #define GRAPHENE_RECENTLY_MISSED_COUNT_DECREMENT             3
 
-#define GRAPHENE_CURRENT_DB_VERSION                          "GPH2.5"
+#define GRAPHENE_CURRENT_DB_VERSION                          "GPH2.9"
 
 #define GRAPHENE_IRREVERSIBLE_THRESHOLD                      (70 * GRAPHENE_1_PERCENT)
 
@@ -204,6 +205,8 @@
 #define DASCOIN_CYCLE_ASSET_PRECISION (static_cast<uint64_t>(1))
 
 #define DASCOIN_DEFAULT_LIMIT_INTERVAL_ELAPSE_TIME_SECONDS (86400)
+#define DASCOIN_SPEND_LIMIT_RESET_BATCH_SIZE (1000) ///< max number of vaults whose limit is reset in a single block
+#define DASCOIN_UPGRADE_BATCH_SIZE (1000) ///< max number of licensed vaults visited by upgrade events in a single block
 #define DASCOIN_DEFAULT_WEB_ASSET_REQUEST_EXPIRATION_TIME_SECONDS (86400)
 #define DASCOIN_DEFAULT_CYCLE_REQUEST_EXPIRATION_TIME_SECONDS (86400)
 
@@ -341,4 +344,5 @@
  */
 ///@{
 #define DAS33_DEFAULT_USE_EXTERNAL_BTC_PRICE  (true)
+#define DAS33_DISTRIBUTION_BATCH_SIZE         (500) ///< max number of pledges distributed in a single block
 ///@}
@@ -120,6 +120,27 @@ namespace graphene { namespace chain {
               timestamp(timestamp) {}
   };
 
+  /**
+   * A distribution of project pledges which did not fit in a single batch. The remaining pledges are distributed
+   * in batches at the end of the following blocks, starting from next_pledge. Pledges made after the distribution
+   * was requested (at or after end_pledge) are not part of it.
+   */
+  class das33_distribution_object : public abstract_object<das33_distribution_object>
+  {
+  public:
+    static const uint8_t space_id = implementation_ids;
+    static const uint8_t type_id  = impl_das33_distribution_object_type;
+
+    das33_project_id_type          project_id;
+    optional<share_type>           phase_number;
+    account_id_type                project_owner;
+    share_type                     to_escrow;
+    share_type                     base_to_pledger;
+    share_type                     bonus_to_pledger;
+    das33_pledge_holder_id_type    next_pledge;
+    das33_pledge_holder_id_type    end_pledge;
+  };
+
   ///////////////////////////////
   // MULTI INDEX CONTAINERS:   //
   ///////////////////////////////
@@ -133,6 +154,7 @@ namespace graphene { namespace chain {
 
   struct by_user;
   struct by_project;
+  struct by_project_phase;
 
   using das33_pledge_holder_multi_index_type = multi_index_container<
     das33_pledge_holder_object,
@@ -157,12 +179,63 @@ namespace graphene { namespace chain {
           member< das33_pledge_holder_object, das33_project_id_type, &das33_pledge_holder_object::project_id >,
           member< object, object_id_type, &object::id >
         >
+      >,
+      ordered_unique<
+        tag<by_project_phase>,
+        composite_key<
+          das33_pledge_holder_object,
+          member< das33_pledge_holder_object, das33_project_id_type, &das33_pledge_holder_object::project_id >,
+          member< das33_pledge_holder_object, share_type, &das33_pledge_holder_object::phase_number >,
+          member< object, object_id_type, &object::id >
+        >
       >
     >
   >;
 
   using das33_pledge_holder_index = generic_index<das33_pledge_holder_object, das33_pledge_holder_multi_index_type>;
 
+  /**
+   * @brief This secondary index keeps the amount of each asset pledged to every project, in total and per phase, and
+   * the tokens each account expects from its pledges, so that the totals can be read without visiting each pledge.
+   */
+  class das33_pledge_totals_index : public secondary_index
+  {
+  public:
+    typedef map<asset_id_type, share_type> asset_totals;
+
+    struct project_totals
+    {
+      asset_totals                  pledged;           ///< over all phases
+      map<share_type, asset_totals> pledged_by_phase;
+    };
+
+    struct expected_totals
+    {
+      share_type base;
+      share_type bonus;
+      uint32_t   count = 0;
+    };
+    /** expected tokens of the pledges of an account to each project, per phase */
+    typedef map<das33_project_id_type, map<share_type, expected_totals>> account_totals;
+
+    virtual void object_inserted( const object& obj ) override;
+    virtual void object_removed( const object& obj ) override;
+    virtual void about_to_modify( const object& before ) override;
+    virtual void object_modified( const object& after  ) override;
+
+    /** @return the totals of the pledges held for a project, nullptr if there are none */
+    const project_totals* find( das33_project_id_type project ) const;
+    /** @return the totals of the pledges held for an account, nullptr if there are none */
+    const account_totals* find( account_id_type account ) const;
+
+  private:
+    void add( const das33_pledge_holder_object& pledge );
+    void subtract( const das33_pledge_holder_object& pledge );
+
+    map<das33_project_id_type, project_totals> _totals;
+    map<account_id_type, account_totals>        _account_totals;
+  };
+
   struct by_project_name;
   typedef multi_index_container<
       das33_project_object,
@@ -180,6 +253,18 @@ namespace graphene { namespace chain {
 
   typedef generic_index<das33_project_object, das33_project_multi_index_type> das33_project_index;
 
+  typedef multi_index_container<
+      das33_distribution_object,
+      indexed_by<
+        ordered_unique<
+          tag<by_id>,
+          member<object, object_id_type, &object::id>
+        >
+     >
+  > das33_distribution_multi_index_type;
+
+  typedef generic_index<das33_distribution_object, das33_distribution_multi_index_type> das33_distribution_index;
+
 } }  // namespace graphene::chain
 
 ///////////////////////////////
@@ -215,3 +300,14 @@ FC_REFLECT_DERIVED( graphene::chain::das33_project_object, (graphene::db::object
                     (phase_limit)
                     (phase_end)
                   )
+
+FC_REFLECT_DERIVED( graphene::chain::das33_distribution_object, (graphene::db::object),
+                    (project_id)
+                    (phase_number)
+                    (project_owner)
+                    (to_escrow)
+                    (base_to_pledger)
+                    (bonus_to_pledger)
+                    (next_pledge)
+                    (end_pledge)
+                  )
@@ -31,18 +31,22 @@
 #include <graphene/chain/genesis_state.hpp>
 #include <graphene/chain/evaluator.hpp>
 #include <graphene/chain/license_objects.hpp>
+#include <graphene/chain/pending_transaction_pool.hpp>
+#include <graphene/chain/pending_transaction_tracker.hpp>
 
 #include <graphene/db/object_database.hpp>
 #include <graphene/db/object.hpp>
 #include <graphene/db/simple_index.hpp>
 #include <fc/optional.hpp>
 #include <fc/signals.hpp>
+#include <fc/thread/thread.hpp>
 
 #include <graphene/chain/protocol/protocol.hpp>
 
 #include <fc/log/logger.hpp>
 
 #include <map>
+#include <unordered_set>
 
 namespace graphene { namespace chain {
    using graphene::db::abstract_object;
@@ -115,6 +119,47 @@ namespace graphene { namespace chain {
          void wipe(const fc::path& data_dir, bool include_blocks);
          void close(bool rewind = true);
 
+         /**
+          * Writes the object database to disk, emitting @ref flushing first.
+          */
+         void flush();
+
+         /**
+          * @brief Serve block reads from memory mappings of the block database files, see
+          * @ref block_database::set_mmap_reads. Must be called before @ref database::open.
+          */
+         void set_block_database_mmap_reads( bool enable ) { _block_id_to_block.set_mmap_reads( enable ); }
+
+         /**
+          * @brief Number of worker threads that fetch, unpack and merkle-check blocks ahead of @ref database::reindex.
+          * Zero (the default) replays on the calling thread only.
+          */
+         void set_replay_threads( uint32_t threads ) { _replay_threads = threads; }
+
+         /**
+          * @brief Maximum number of licensed vaults visited by upgrade events in a single block, defaults to
+          * DASCOIN_UPGRADE_BATCH_SIZE. This changes when upgrade events complete, so it is only meant for tests.
+          */
+         void set_upgrade_batch_size( uint32_t size ) { _upgrade_batch_size = size; }
+
+         /**
+          * @brief Maximum number of vaults whose spending limit is reset in a single block, defaults to
+          * DASCOIN_SPEND_LIMIT_RESET_BATCH_SIZE. This changes when limits are reset, so it is only meant for tests.
+          */
+         void set_spend_limit_reset_batch_size( uint32_t size ) { _spend_limit_reset_batch_size = size; }
+
+         /**
+          * @brief Number of threads used to recover the signature keys of a block's transactions before it is applied.
+          * Zero (the default) uses one thread per hardware thread. Must be called before the first block is applied.
+          */
+         void set_signature_threads( uint32_t threads ) { _signature_thread_count = threads; }
+
+         /**
+          * @brief Limits and priorities of the pending transaction pool, see @ref pending_transaction_pool.
+          */
+         void set_pending_pool_options( const pending_pool_options& options ) { _pending_pool.set_options( options ); }
+         pending_pool_stats get_pending_pool_stats()const { return _pending_pool.get_stats(); }
+
          //////////////////// db_block.cpp ////////////////////
 
          /**
@@ -143,7 +188,18 @@ namespace graphene { namespace chain {
          bool push_block( const signed_block& b, uint32_t skip = skip_nothing );
          processed_transaction push_transaction( const signed_transaction& trx, uint32_t skip = skip_nothing );
          bool _push_block( const signed_block& b );
-         processed_transaction _push_transaction( const signed_transaction& trx );
+         /**
+          * @param verified_authorities the objects read when the transaction was verified, if the verification is
+          * skipped because it was already done, otherwise the ones read by _apply_transaction are recorded
+          */
+         processed_transaction _push_transaction( const signed_transaction& trx,
+                                                  pending_transaction_tracker::dependency_set* verified_authorities = nullptr );
+         /**
+          * Pushes a pending transaction whose signatures and authorities have already been verified against a state
+          * in which none of its dependencies have changed since, so the verification is skipped.
+          */
+         processed_transaction _push_verified_transaction( const signed_transaction& trx,
+                                                           pending_transaction_tracker::dependency_set&& dependencies );
 
          ///@throws fc::exception if the proposed transaction fails to apply.
          processed_transaction push_proposal( const proposal_object& proposal );
@@ -215,6 +271,12 @@ namespace graphene { namespace chain {
           */
          fc::signal<void(const vector<object_id_type>&, const vector<const object*>&, const flat_set<account_id_type>&)>  removed_objects;
 
+         /**
+          *  Emitted when the object database is about to be written to disk, so that plugins can make the state they
+          *  keep outside of it durable first.
+          */
+         fc::signal<void()>                              flushing;
+
          //////////////////// db_witness_schedule.cpp ////////////////////
 
          /**
@@ -567,6 +629,9 @@ namespace graphene { namespace chain {
           * can be reapplied at the proper time */
          std::deque< signed_transaction >       _popped_tx;
 
+         /** tracks what the verification of each of the pending transactions depends on */
+         pending_transaction_tracker            _pending_tx_tracker;
+
          /**
           * @}
           */
@@ -594,6 +659,24 @@ namespace graphene { namespace chain {
 
          share_type get_eur_limit(const optional<license_information_object> &license_info) const;
 
+         //////////////////// db_das33.cpp ////////////////////
+
+         /**
+          * Distribute the pledges of a project distribution in pledge id order, starting from its next pledge.
+          *
+          * @param distribution The project, phase, percentages and pledge range of the distribution.
+          * @param budget The maximum number of pledges to distribute, decreased by the number distributed.
+          * @return The next pledge to distribute, nothing if the whole distribution is done.
+          **/
+         optional<das33_pledge_holder_id_type> distribute_das33_pledges(const das33_distribution_object& distribution,
+                                                                         uint32_t& budget);
+
+         /**
+          * Distribute a single pledge and remove it once everything was distributed.
+          **/
+         void distribute_das33_pledge(const das33_pledge_holder_object& pledge,
+                                      const das33_distribution_object& distribution);
+
          //////////////////// db_queue.cpp ////////////////////
 
          object_id_type push_queue_submission(const string& origin, optional<license_type_id_type> license,
@@ -624,7 +707,13 @@ namespace graphene { namespace chain {
          operation_result      apply_operation( transaction_evaluation_state& eval_state, const operation& op );
       private:
          void                  _apply_block( const signed_block& next_block );
-         processed_transaction _apply_transaction( const signed_transaction& trx );
+         vector<optional<flat_set<public_key_type>>> precompute_signature_keys( const signed_block& next_block );
+         /**
+          * @param signature_keys the keys recovered from the transaction's signatures, if they have been recovered
+          * already, e.g. by @ref precompute_signature_keys
+          */
+         processed_transaction _apply_transaction( const signed_transaction& trx,
+                                                   const flat_set<public_key_type>* signature_keys = nullptr );
 
          ///Steps involved in applying a new block
          ///@{
@@ -648,6 +737,8 @@ namespace graphene { namespace chain {
          void distribute_issue_requested_assets();
          void mint_dascoin_rewards();
          void reset_spending_limits();
+         void process_das33_distributions();
+         void process_upgrade_events();
          void daspay_clearing_start();
          void resolve_delayed_operations();
 private:
@@ -665,6 +756,7 @@ private:
          void update_active_committee_members();
          void perform_upgrades(const account_object& account, const upgrade_event_object& upgrade);
          void perform_upgrades();
+         optional<account_id_type> continue_upgrade_event(const upgrade_event_object& upgrade, uint32_t& budget);
          void update_worker_votes();
 
          template<typename IndexType, typename IndexBy, class... HelperTypes>
@@ -687,6 +779,9 @@ public:
 
 private:
          vector< processed_transaction >        _pending_tx;
+         pending_transaction_pool               _pending_pool;
+         /// objects read while verifying the authorities of the last transaction, see pending_transaction_tracker
+         pending_transaction_tracker::dependency_set _verified_authorities;
          fork_database                          _fork_db;
 
          /**
@@ -714,6 +809,8 @@ private:
           * order they occur and is cleared after account history plugin is updated
           */
          vector<optional<operation_history_object> >  _virtual_ops;
+         /// virtual_op numbers of the entries in _virtual_ops, used to skip duplicates
+         std::unordered_set<uint16_t>                  _virtual_op_numbers;
 
          uint32_t                          _current_block_num    = 0;
          uint16_t                          _current_trx_in_block = 0;
@@ -729,6 +826,15 @@ private:
 
          node_property_object              _node_property_object;
 
+         uint32_t                          _replay_threads = 0;
+
+         uint32_t                          _upgrade_batch_size = DASCOIN_UPGRADE_BATCH_SIZE;
+
+         uint32_t                          _spend_limit_reset_batch_size = DASCOIN_SPEND_LIMIT_RESET_BATCH_SIZE;
+
+         uint32_t                          _signature_thread_count = 0;
+         vector<std::shared_ptr<fc::thread>> _signature_threads;
+
          transaction_evaluation_state      _genesis_eval_state;
 
    };
@@ -63,15 +63,22 @@ struct skip_flags_restorer
  * Class used to help the without_pending_transactions
  * implementation.
  *
+ * Pending transactions whose verification did not read anything
+ * written by the blocks pushed in between are re-applied without
+ * verifying their signatures and authorities again, see
+ * pending_transaction_tracker.
+ *
  * TODO:  Change the name of this class to better reflect the fact
  * that it restores popped transactions as well as pending transactions.
  */
 struct pending_transactions_restorer
 {
    pending_transactions_restorer( database& db, std::vector<processed_transaction>&& pending_transactions )
-      : _db(db), _pending_transactions( std::move(pending_transactions) )
+      : _db(db), _pending_transactions( std::move(pending_transactions) ),
+        _dependencies( db._pending_tx_tracker.take() )
    {
       _db.clear_pending();
+      _db._pending_tx_tracker.start_collecting();
    }
 
    ~pending_transactions_restorer()
@@ -92,10 +99,15 @@ struct pending_transactions_restorer
       {
          try
          {
-            if( !_db.is_known_transaction( tx.id() ) ) {
+            const transaction_id_type id = tx.id();
+            if( !_db.is_known_transaction( id ) ) {
                // since push_transaction() takes a signed_transaction,
                // the operation_results field will be ignored.
-               _db._push_transaction( tx );
+               auto dependencies = _dependencies.find( id );
+               if( dependencies != _dependencies.end() && !_db._pending_tx_tracker.is_touched( dependencies->second ) )
+                  _db._push_verified_transaction( tx, std::move( dependencies->second ) );
+               else
+                  _db._push_transaction( tx );
             }
          }
          catch( const fc::exception& e )
@@ -110,6 +122,7 @@ struct pending_transactions_restorer
 
    database& _db;
    std::vector< processed_transaction > _pending_transactions;
+   pending_transaction_tracker::dependency_map _dependencies;
 };
 
 /**
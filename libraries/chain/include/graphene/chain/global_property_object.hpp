@@ -183,6 +183,12 @@ namespace graphene { namespace chain {
           */
          time_point_sec next_spend_limit_reset = fc::time_point_sec();
 
+         /**
+          * While a spend limit reset is in progress, this is the first vault which has not been reset yet.
+          * Empty when there is no reset in progress.
+          */
+         optional<account_id_type> spend_limit_reset_cursor;
+
          /**
           * Last dascoin trade price on the DSC:WEBEUR market.
           */
@@ -258,6 +264,7 @@ FC_REFLECT_DERIVED( graphene::chain::dynamic_global_property_object, (graphene::
                     (last_irreversible_block_num)
                     (next_dascoin_reward_time)
                     (next_spend_limit_reset)
+                    (spend_limit_reset_cursor)
                     (is_root_authority_enabled_flag)
                     (last_dascoin_price)
                     (last_btc_price)
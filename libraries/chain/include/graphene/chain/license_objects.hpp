@@ -145,7 +145,7 @@ namespace graphene { namespace chain {
       upgrade_type requeue_upgrade;
       upgrade_type return_upgrade;
 
-      bool is_manual_submit()
+      bool is_manual_submit() const
       {
         return (vault_license_kind == license_kind::locked_frequency || vault_license_kind == license_kind::utility);
       }
@@ -304,6 +304,36 @@ namespace graphene { namespace chain {
 
   typedef generic_index<license_information_object, license_information_multi_index_type> license_information_index;
 
+  /**
+   * @brief The amount of DASC which a number of cycles is worth at a frequency, which must not be zero.
+   * database::cycles_to_dascoin and license_totals_index both use it, so the totals agree with the database.
+   */
+  share_type cycles_to_dascoin( share_type cycles, frequency_type frequency );
+
+  /**
+   * @brief Keeps the cycle and DASC totals of all vault licenses which are submitted manually.
+   *
+   * The totals are the sums of what database_access_layer::get_total_cycles returns for each vault, and are updated
+   * as license information objects change, so that they can be read without visiting every account.
+   */
+  class license_totals_index : public secondary_index
+  {
+  public:
+    virtual void object_inserted( const object& obj ) override;
+    virtual void object_removed( const object& obj ) override;
+    virtual void about_to_modify( const object& before ) override;
+    virtual void object_modified( const object& after  ) override;
+
+    share_type total_cycles() const { return _total_cycles; }
+    share_type total_dascoin() const { return _total_dascoin; }
+
+  private:
+    void add( const license_information_object& lio, bool remove );
+
+    share_type _total_cycles;
+    share_type _total_dascoin;
+  };
+
   struct by_name;
   struct by_amount;
   typedef multi_index_container<
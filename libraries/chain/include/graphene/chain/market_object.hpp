@@ -99,6 +99,42 @@ typedef multi_index_container<
 
 typedef generic_index<limit_order_object, limit_order_multi_index_type> limit_order_index;
 
+/**
+ *  @brief This secondary index aggregates the limit orders of every market by price, so that the order book can be
+ *  read level by level without visiting each order.
+ */
+class limit_order_price_level_index : public secondary_index
+{
+   public:
+      struct price_level
+      {
+         share_type for_sale;     ///< total amount for sale at this price
+         share_type quote_volume; ///< sum of what each order receives, rounded per order like the order book API does
+         uint32_t   count = 0;
+      };
+      /** levels are sorted like the by_price index of limit_order_index, best price of each market first */
+      typedef std::map< price, price_level, std::greater<price> > level_map;
+
+      virtual void object_inserted( const object& obj ) override;
+      virtual void object_removed( const object& obj ) override;
+      virtual void about_to_modify( const object& before ) override;
+      virtual void object_modified( const object& after  ) override;
+
+      const level_map& levels()const { return _levels; }
+
+      /**
+       * @return the amount order receives, rounded the way the grouped order book queries round it, quoted in the
+       * asset with the lower id when the order sells the asset with the higher id and the other way round
+       */
+      static share_type rounded_quote_amount( const limit_order_object& order );
+
+   private:
+      void add( const limit_order_object& order );
+      void subtract( const limit_order_object& order );
+
+      level_map _levels;
+};
+
 struct market_key
 {
   asset_id_type        base;
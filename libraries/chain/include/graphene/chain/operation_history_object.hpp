@@ -107,6 +107,7 @@ namespace graphene { namespace chain {
          operation_history_id_type            operation_id;
          uint32_t                             sequence = 0; /// the operation position within the given account
          account_transaction_history_id_type  next;
+         uint32_t                             op_type = 0; /// the tag of the operation, as returned by operation::which()
 
          //std::pair<account_id_type,operation_history_id_type>  account_op()const  { return std::tie( account, operation_id ); }
          //std::pair<account_id_type,uint32_t>                   account_seq()const { return std::tie( account, sequence );     }
@@ -115,6 +116,7 @@ namespace graphene { namespace chain {
    struct by_id;
 struct by_seq;
 struct by_op;
+struct by_op_type;
 typedef multi_index_container<
    account_transaction_history_object,
    indexed_by<
@@ -130,6 +132,13 @@ typedef multi_index_container<
             member< account_transaction_history_object, account_id_type, &account_transaction_history_object::account>,
             member< account_transaction_history_object, operation_history_id_type, &account_transaction_history_object::operation_id>
          >
+      >,
+      ordered_unique< tag<by_op_type>,
+         composite_key< account_transaction_history_object,
+            member< account_transaction_history_object, account_id_type, &account_transaction_history_object::account>,
+            member< account_transaction_history_object, uint32_t, &account_transaction_history_object::op_type>,
+            member< account_transaction_history_object, uint32_t, &account_transaction_history_object::sequence>
+         >
       >
    >
 > account_transaction_history_multi_index_type;
@@ -143,4 +152,4 @@ FC_REFLECT_DERIVED( graphene::chain::operation_history_object, (graphene::chain:
                     (op)(result)(block_num)(block_timestamp)(trx_in_block)(op_in_trx)(virtual_op) )
 
 FC_REFLECT_DERIVED( graphene::chain::account_transaction_history_object, (graphene::chain::object),
-                    (account)(operation_id)(sequence)(next) )
+                    (account)(operation_id)(sequence)(next)(op_type) )
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+#include <graphene/chain/config.hpp>
+#include <graphene/chain/protocol/transaction.hpp>
+
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/composite_key.hpp>
+
+namespace graphene { namespace chain {
+   using boost::multi_index_container;
+   using namespace boost::multi_index;
+
+   /**
+    * Node local configuration of the pending transaction pool.
+    */
+   struct pending_pool_options
+   {
+      /// maximum number of pending transactions, 0 for no limit
+      uint32_t                max_size = 0;
+      /// maximum number of pending transactions paid by a single account, 0 for no limit
+      uint32_t                account_quota = 0;
+      /// priority of transactions containing an operation, by operation tag; operations not listed have priority 0
+      flat_map<int, int32_t>  operation_priorities;
+   };
+
+   /**
+    * Statistics of the pending transaction pool, exposed through the node API.
+    */
+   struct pending_pool_stats
+   {
+      uint32_t                size = 0;
+      uint32_t                max_size = 0;
+      uint32_t                account_quota = 0;
+      /// number of distinct accounts paying for the pending transactions
+      uint32_t                account_count = 0;
+      /// number of transactions rejected because the pool or the fee payer's quota was full
+      uint64_t                rejected = 0;
+      /// number of pending transactions dropped in favour of a transaction with a higher priority
+      uint64_t                evicted = 0;
+      /// number of pending transactions per priority
+      map<int32_t, uint32_t>  size_by_priority;
+   };
+
+   /**
+    * @class pending_transaction_pool
+    * @brief Bounds the pending transactions and decides the order they are put into generated blocks
+    *
+    * The pending transactions themselves are still kept by the database in the order they were applied to the
+    * pending state; the pool keeps a priority, fee payer and core asset fee for each of them. A transaction's
+    * priority is the highest priority configured for any of its operations.
+    *
+    * When the pool is full, a new transaction is only accepted if its priority is higher than the lowest pending
+    * one, which is then evicted. Transactions over their fee payer's quota are rejected.
+    */
+   class pending_transaction_pool
+   {
+      public:
+         void set_options( const pending_pool_options& options ) { _options = options; }
+         const pending_pool_options& options()const { return _options; }
+
+         /**
+          * Checks whether trx can be added to the pool, throwing if it cannot.
+          * @return the id of the pending transaction which has to be evicted to make room for trx
+          */
+         optional<transaction_id_type> admit( const signed_transaction& trx );
+
+         /** Records a transaction which has been added to the pending transactions */
+         void insert( const signed_transaction& trx );
+         /** Removes an evicted transaction */
+         void evict( const transaction_id_type& id );
+         void clear();
+
+         /**
+          * Orders the pending transactions for inclusion in a block: by priority first, then round robin over the
+          * fee payers and by fee. The transactions of one fee payer keep their relative order.
+          *
+          * @param pending the pending transactions, in the order they were applied
+          * @return indices into pending
+          */
+         vector<size_t> block_order( const vector<processed_transaction>& pending )const;
+
+         pending_pool_stats get_stats()const;
+
+      private:
+         struct entry
+         {
+            transaction_id_type id;
+            account_id_type     fee_payer;
+            int32_t             priority = 0;
+            share_type          fee;
+            uint64_t            sequence = 0;
+         };
+         struct by_id;
+         struct by_priority;
+         struct by_fee_payer;
+         typedef multi_index_container<
+            entry,
+            indexed_by<
+               hashed_unique< tag<by_id>, member< entry, transaction_id_type, &entry::id >, std::hash<transaction_id_type> >,
+               ordered_unique< tag<by_priority>,
+                  composite_key< entry,
+                     member< entry, int32_t, &entry::priority >,
+                     member< entry, share_type, &entry::fee >,
+                     member< entry, uint64_t, &entry::sequence >
+                  >,
+                  composite_key_compare< std::less<int32_t>, std::less<share_type>, std::greater<uint64_t> >
+               >,
+               ordered_non_unique< tag<by_fee_payer>, member< entry, account_id_type, &entry::fee_payer > >
+            >
+         > entry_index_type;
+
+         entry make_entry( const signed_transaction& trx )const;
+
+         pending_pool_options  _options;
+         entry_index_type      _entries;
+         uint64_t              _next_sequence = 0;
+         uint64_t              _rejected = 0;
+         uint64_t              _evicted = 0;
+   };
+
+} } // graphene::chain
+
+FC_REFLECT( graphene::chain::pending_pool_options, (max_size)(account_quota)(operation_priorities) )
+FC_REFLECT( graphene::chain::pending_pool_stats,
+            (size)(max_size)(account_quota)(account_count)(rejected)(evicted)(size_by_priority) )
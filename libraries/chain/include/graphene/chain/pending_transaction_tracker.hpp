@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+#include <graphene/chain/protocol/types.hpp>
+#include <graphene/db/undo_database.hpp>
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace graphene { namespace chain {
+   using graphene::db::undo_state;
+
+   /**
+    * @class pending_transaction_tracker
+    * @brief Tracks what the pending transactions depend on, so that they are not fully revalidated after every block
+    *
+    * The pending transactions have to be undone before a block is applied and re-applied afterwards. Re-applying
+    * them runs their evaluators again, but their signatures and authorities only need to be verified again when
+    * something they were verified against has changed since.
+    *
+    * For every pending transaction (by transaction id) the tracker keeps the set of objects its
+    * verification read: the accounts whose authorities were consulted and the global properties. The objects
+    * written by the blocks applied since the pending transactions were set aside are collected as well, and a
+    * transaction needs a full revalidation only if the two sets intersect. Popping a block invalidates everything,
+    * as the popped state is not tracked.
+    */
+   class pending_transaction_tracker
+   {
+      public:
+         typedef flat_set<object_id_type> dependency_set;
+         typedef std::unordered_map<transaction_id_type, dependency_set, std::hash<transaction_id_type>> dependency_map;
+
+         /** Records the dependencies of a transaction which has just been added to the pending transactions */
+         void insert( const transaction_id_type& id, dependency_set&& dependencies );
+         /** Removes the dependencies of all the pending transactions, returning them by transaction id */
+         dependency_map take();
+         /** Removes the dependencies of a pending transaction */
+         void erase( const transaction_id_type& id );
+         void clear();
+
+         /** Starts collecting the objects written by blocks, called when the pending transactions are set aside */
+         void start_collecting();
+         /** Records the objects written by a block, state is the undo state of the block about to be committed */
+         void on_block_applied( const undo_state& state );
+         /** Called when a block is popped, all the pending transactions have to be fully revalidated afterwards */
+         void on_block_popped();
+
+         /** @return true if any of the dependencies was written since start_collecting() was called */
+         bool is_touched( const dependency_set& dependencies )const;
+
+      private:
+         dependency_map                     _dependencies;
+         std::unordered_set<object_id_type> _touched;
+         bool                               _popped = false;
+   };
+
+} } // graphene::chain
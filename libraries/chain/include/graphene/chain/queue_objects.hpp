@@ -29,6 +29,7 @@
 #include <graphene/db/object.hpp>
 
 #include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/ranked_index.hpp>
 
 namespace graphene { namespace chain {
 
@@ -70,13 +71,18 @@ namespace graphene { namespace chain {
 
   struct by_account;
   struct by_time;
+
+  /**
+   * The by_time ordering is ranked so that the position of a submission in the queue (rank) and the submission at a
+   * given position (nth) can both be found in logarithmic time.
+   */
   typedef multi_index_container<
     reward_queue_object,
     indexed_by<
       ordered_unique< tag<by_id>,
         member<object, object_id_type, &object::id>
       >,
-      ordered_unique< tag<by_time>,
+      ranked_unique< tag<by_time>,
         composite_key< reward_queue_object,
           member< reward_queue_object, time_point_sec, &reward_queue_object::time>,
           member< object, object_id_type, &object::id>
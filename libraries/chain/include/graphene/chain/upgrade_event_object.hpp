@@ -50,6 +50,8 @@ namespace graphene { namespace chain {
       string comment;
       bool historic = false;
       uint16_t num_of_executions = 0;
+      /// While an execution is in progress, the first licensed vault which has not been visited yet
+      optional<account_id_type> cursor;
 
       extensions_type extensions;
 
@@ -103,5 +105,6 @@ FC_REFLECT_DERIVED( graphene::chain::upgrade_event_object, (graphene::db::object
                     (subsequent_execution_times)
                     (comment)
                     (num_of_executions)
+                    (cursor)
                     (extensions)
                   )
@@ -23,13 +23,66 @@
  */
 
 #include <graphene/chain/license_objects.hpp>
+#include <graphene/chain/config.hpp>
 
 namespace graphene { namespace chain {
 
+  share_type cycles_to_dascoin( share_type cycles, frequency_type frequency )
+  {
+    FC_ASSERT( frequency != 0 );
+    return ( cycles * DASCOIN_DEFAULT_ASSET_PRECISION * DASCOIN_FREQUENCY_PRECISION ) / frequency;
+  }
+
   void license_type_object::validate() const
   {
     FC_ASSERT( name.size() >= GRAPHENE_MIN_ACCOUNT_NAME_LENGTH );
     FC_ASSERT( name.size() <= GRAPHENE_MAX_ACCOUNT_NAME_LENGTH );
   }
 
+  void license_totals_index::add( const license_information_object& lio, bool remove )
+  {
+    if( !lio.is_manual_submit() )
+      return;
+
+    // Mirrors database_access_layer::get_total_cycles: dascoin is computed from the running cycle total.
+    share_type cycles;
+    share_type dascoin;
+    for( const auto& record : lio.history )
+    {
+      cycles += record.total_cycles();
+      dascoin += cycles_to_dascoin( cycles, record.frequency_lock );
+    }
+
+    if( remove )
+    {
+      _total_cycles -= cycles;
+      _total_dascoin -= dascoin;
+    }
+    else
+    {
+      _total_cycles += cycles;
+      _total_dascoin += dascoin;
+    }
+  }
+
+  void license_totals_index::object_inserted( const object& obj )
+  {
+    add( static_cast<const license_information_object&>( obj ), false );
+  }
+
+  void license_totals_index::object_removed( const object& obj )
+  {
+    add( static_cast<const license_information_object&>( obj ), true );
+  }
+
+  void license_totals_index::about_to_modify( const object& before )
+  {
+    add( static_cast<const license_information_object&>( before ), true );
+  }
+
+  void license_totals_index::object_modified( const object& after )
+  {
+    add( static_cast<const license_information_object&>( after ), false );
+  }
+
 } } // namespace graphene::chain
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/chain/market_object.hpp>
+
+#include <cmath>
+
+namespace graphene { namespace chain {
+
+share_type limit_order_price_level_index::rounded_quote_amount( const limit_order_object& order )
+{
+   const double real_price = order.sell_price.to_real();
+   if( order.sell_price.base.asset_id > order.sell_price.quote.asset_id )
+      return static_cast<int64_t>( std::round( order.for_sale.value * ( 1 / real_price ) ) );
+   return static_cast<int64_t>( std::round( order.for_sale.value / real_price ) );
+}
+
+void limit_order_price_level_index::add( const limit_order_object& order )
+{
+   auto& level = _levels[order.sell_price];
+   level.for_sale += order.for_sale;
+   level.quote_volume += rounded_quote_amount( order );
+   ++level.count;
+}
+
+void limit_order_price_level_index::subtract( const limit_order_object& order )
+{
+   auto itr = _levels.find( order.sell_price );
+   assert( itr != _levels.end() );
+   if( itr == _levels.end() )
+      return;
+   if( --itr->second.count == 0 )
+   {
+      _levels.erase( itr );
+      return;
+   }
+   itr->second.for_sale -= order.for_sale;
+   itr->second.quote_volume -= rounded_quote_amount( order );
+}
+
+void limit_order_price_level_index::object_inserted( const object& obj )
+{
+   assert( dynamic_cast<const limit_order_object*>(&obj) ); // for debug only
+   add( static_cast<const limit_order_object&>(obj) );
+}
+
+void limit_order_price_level_index::object_removed( const object& obj )
+{
+   assert( dynamic_cast<const limit_order_object*>(&obj) ); // for debug only
+   subtract( static_cast<const limit_order_object&>(obj) );
+}
+
+void limit_order_price_level_index::about_to_modify( const object& before )
+{
+   assert( dynamic_cast<const limit_order_object*>(&before) ); // for debug only
+   subtract( static_cast<const limit_order_object&>(before) );
+}
+
+void limit_order_price_level_index::object_modified( const object& after )
+{
+   assert( dynamic_cast<const limit_order_object*>(&after) ); // for debug only
+   add( static_cast<const limit_order_object&>(after) );
+}
+
+} } // graphene::chain
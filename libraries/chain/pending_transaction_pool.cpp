@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/chain/pending_transaction_pool.hpp>
+
+namespace graphene { namespace chain {
+
+namespace {
+
+struct operation_fee_payer_getter
+{
+   typedef account_id_type result_type;
+
+   template<typename T>
+   account_id_type operator()( const T& op )const { return op.fee_payer(); }
+};
+
+struct operation_fee_getter
+{
+   typedef asset result_type;
+
+   template<typename T>
+   asset operator()( const T& op )const { return op.fee; }
+};
+
+} // anonymous namespace
+
+pending_transaction_pool::entry pending_transaction_pool::make_entry( const signed_transaction& trx )const
+{
+   entry e;
+   e.id = trx.id();
+   e.sequence = _next_sequence;
+   if( !trx.operations.empty() )
+      e.fee_payer = trx.operations.front().visit( operation_fee_payer_getter() );
+
+   bool has_priority = false;
+   for( const auto& op : trx.operations )
+   {
+      auto itr = _options.operation_priorities.find( op.which() );
+      int32_t op_priority = itr == _options.operation_priorities.end() ? 0 : itr->second;
+      if( !has_priority || op_priority > e.priority )
+         e.priority = op_priority;
+      has_priority = true;
+
+      const asset fee = op.visit( operation_fee_getter() );
+      if( fee.asset_id == asset_id_type() )
+         e.fee += fee.amount;
+   }
+   return e;
+}
+
+optional<transaction_id_type> pending_transaction_pool::admit( const signed_transaction& trx )
+{
+   const entry e = make_entry( trx );
+
+   if( _options.account_quota > 0 && _entries.get<by_fee_payer>().count( e.fee_payer ) >= _options.account_quota )
+   {
+      ++_rejected;
+      FC_THROW( "Account ${a} already has ${n} pending transactions", ("a", e.fee_payer)("n", _options.account_quota) );
+   }
+
+   if( _options.max_size == 0 || _entries.size() < _options.max_size )
+      return {};
+
+   // The pool is full, the new transaction may only replace one with a lower priority:
+   const auto& lowest = *_entries.get<by_priority>().begin();
+   if( lowest.priority >= e.priority )
+   {
+      ++_rejected;
+      FC_THROW( "The pending transaction pool is full (${n} transactions)", ("n", _entries.size()) );
+   }
+   return lowest.id;
+}
+
+void pending_transaction_pool::insert( const signed_transaction& trx )
+{
+   _entries.insert( make_entry( trx ) );
+   ++_next_sequence;
+}
+
+void pending_transaction_pool::evict( const transaction_id_type& id )
+{
+   auto& idx = _entries.get<by_id>();
+   auto itr = idx.find( id );
+   if( itr != idx.end() )
+   {
+      idx.erase( itr );
+      ++_evicted;
+   }
+}
+
+void pending_transaction_pool::clear()
+{
+   _entries.clear();
+}
+
+vector<size_t> pending_transaction_pool::block_order( const vector<processed_transaction>& pending )const
+{
+   struct position
+   {
+      size_t     index;
+      int32_t    priority;
+      uint32_t   rank;
+      share_type fee;
+   };
+
+   vector<position> positions;
+   positions.reserve( pending.size() );
+
+   // A fee payer's later transactions may depend on its earlier ones, so a transaction never gets a higher
+   // priority than the transactions of the same fee payer before it. Together with the rank this keeps
+   // their relative order.
+   flat_map<account_id_type, std::pair<uint32_t, int32_t>> payer_state;
+   const auto& idx = _entries.get<by_id>();
+   for( size_t i = 0; i < pending.size(); ++i )
+   {
+      auto itr = idx.find( pending[i].id() );
+      entry e = itr != idx.end() ? *itr : make_entry( pending[i] );
+
+      auto state = payer_state.find( e.fee_payer );
+      if( state == payer_state.end() )
+         state = payer_state.emplace( e.fee_payer, std::make_pair( 0u, e.priority ) ).first;
+      else
+         state->second.second = std::min( state->second.second, e.priority );
+
+      positions.push_back( { i, state->second.second, state->second.first++, e.fee } );
+   }
+
+   std::stable_sort( positions.begin(), positions.end(), []( const position& a, const position& b ) {
+      if( a.priority != b.priority )
+         return a.priority > b.priority;
+      if( a.rank != b.rank )
+         return a.rank < b.rank;
+      return a.fee > b.fee;
+   });
+
+   vector<size_t> result;
+   result.reserve( positions.size() );
+   for( const auto& p : positions )
+      result.push_back( p.index );
+   return result;
+}
+
+pending_pool_stats pending_transaction_pool::get_stats()const
+{
+   pending_pool_stats stats;
+   stats.size = _entries.size();
+   stats.max_size = _options.max_size;
+   stats.account_quota = _options.account_quota;
+   stats.rejected = _rejected;
+   stats.evicted = _evicted;
+
+   const auto& payer_idx = _entries.get<by_fee_payer>();
+   for( auto itr = payer_idx.begin(); itr != payer_idx.end(); itr = payer_idx.upper_bound( itr->fee_payer ) )
+      ++stats.account_count;
+
+   for( const auto& e : _entries )
+      ++stats.size_by_priority[e.priority];
+   return stats;
+}
+
+} } // graphene::chain
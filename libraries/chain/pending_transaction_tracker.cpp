@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/chain/pending_transaction_tracker.hpp>
+
+namespace graphene { namespace chain {
+
+void pending_transaction_tracker::insert( const transaction_id_type& id, dependency_set&& dependencies )
+{
+   _dependencies[id] = std::move(dependencies);
+}
+
+pending_transaction_tracker::dependency_map pending_transaction_tracker::take()
+{
+   dependency_map result;
+   std::swap( result, _dependencies );
+   return result;
+}
+
+void pending_transaction_tracker::erase( const transaction_id_type& id )
+{
+   _dependencies.erase( id );
+}
+
+void pending_transaction_tracker::clear()
+{
+   _dependencies.clear();
+}
+
+void pending_transaction_tracker::start_collecting()
+{
+   _touched.clear();
+   _popped = false;
+}
+
+void pending_transaction_tracker::on_block_applied( const undo_state& state )
+{
+   for( const auto& item : state.old_values )
+      _touched.insert( item.first );
+   for( const auto& item : state.removed )
+      _touched.insert( item.first );
+}
+
+void pending_transaction_tracker::on_block_popped()
+{
+   _popped = true;
+}
+
+bool pending_transaction_tracker::is_touched( const dependency_set& dependencies )const
+{
+   if( _popped )
+      return true;
+   for( const auto& id : dependencies )
+      if( _touched.find( id ) != _touched.end() )
+         return true;
+   return false;
+}
+
+} } // graphene::chain
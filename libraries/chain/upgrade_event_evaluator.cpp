@@ -100,6 +100,7 @@ namespace graphene { namespace chain {
     d.perform_chain_authority_check("license administration", license_admin_id, op_creator_obj);
 
     FC_ASSERT( !o.executed(), "Cannot update upgrade event which has been executed." );
+    FC_ASSERT( !o.cursor.valid(), "Cannot update upgrade event while it is being executed." );
 
     if (op.execution_time.valid())
     {
@@ -190,6 +191,8 @@ namespace graphene { namespace chain {
 
     FC_ASSERT( !o.executed(), "Cannot delete upgrade event which has been executed" );
 
+    FC_ASSERT( !o.cursor.valid(), "Cannot delete upgrade event while it is being executed." );
+
     _upgrade_event = &o;
 
     return {};
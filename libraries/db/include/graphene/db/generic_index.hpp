@@ -78,6 +78,27 @@ namespace graphene { namespace chain {
             _indices.erase( _indices.iterator_to( static_cast<const ObjectType&>(obj) ) );
          }
 
+         /** Same as create, but the constructor is called directly instead of through a std::function */
+         template<typename Constructor>
+         const ObjectType& direct_create( const Constructor& constructor )
+         {
+            ObjectType item;
+            item.id = get_next_id();
+            constructor( item );
+            auto insert_result = _indices.insert( std::move(item) );
+            FC_ASSERT(insert_result.second, "Could not create object! Most likely a uniqueness constraint is violated.");
+            use_next_id();
+            return *insert_result.first;
+         }
+
+         /** Same as modify, but the callback is called directly instead of through a std::function */
+         template<typename Lambda>
+         void direct_modify( const ObjectType& obj, const Lambda& m )
+         {
+            auto ok = _indices.modify( _indices.iterator_to( obj ), [&m]( ObjectType& o ){ m(o); } );
+            FC_ASSERT( ok, "Could not modify object, most likely a index constraint was violated" );
+         }
+
          virtual const object* find( object_id_type id )const override
          {
             auto itr = _indices.find( id );
@@ -96,6 +96,14 @@ namespace graphene { namespace db {
          virtual void open( const fc::path& db ) = 0;
          virtual void save( const fc::path& db ) = 0;
 
+         /**
+          *  @return true if objects or the next id changed since the index was last opened or saved, i.e. the file
+          *  on disk is out of date and must be written on the next flush.
+          */
+         virtual bool has_unsaved_changes()const { return true; }
+         /** Forces the index to be written on the next flush, e.g. after its file was deleted */
+         virtual void mark_unsaved() {}
+
 
 
          /** @return the object with id or nullptr if not found */
@@ -165,9 +173,10 @@ namespace graphene { namespace db {
          void on_modify( const object& obj );
 
          template<typename T>
-         void add_secondary_index()
+         T* add_secondary_index()
          {
             _sindex.emplace_back( new T() );
+            return static_cast<T*>( _sindex.back().get() );
          }
 
          template<typename T>
@@ -213,15 +222,22 @@ namespace graphene { namespace db {
          { return object_type::type_id; }
 
          virtual object_id_type get_next_id()const override              { return _next_id;    }
-         virtual void           use_next_id()override                    { ++_next_id.number;  }
-         virtual void           set_next_id( object_id_type id )override { _next_id = id;      }
+         virtual void           use_next_id()override                    { ++_next_id.number; _unsaved_changes = true; }
+         virtual void           set_next_id( object_id_type id )override { _next_id = id; _unsaved_changes = true; }
+
+         virtual bool has_unsaved_changes()const override { return _unsaved_changes; }
+         virtual void mark_unsaved() override { _unsaved_changes = true; }
 
          fc::sha256 get_object_version()const
          {
-            std::string desc = "1.0";//get_type_description<object_type>();
+            std::string desc = "1.1";//get_type_description<object_type>();
             return fc::sha256::hash(desc);
          }
 
+         /**
+          *  The file holds the next id, the object version, the number of objects and then the packed objects. All
+          *  objects are unpacked into a preallocated vector before they are moved into the index.
+          */
          virtual void open( const path& db )override
          { 
             if( !fc::exists( db ) ) return;
@@ -229,18 +245,24 @@ namespace graphene { namespace db {
             fc::mapped_region mr( fm, fc::read_only, 0, fc::file_size(db) );
             fc::datastream<const char*> ds( (const char*)mr.get_address(), mr.get_size() );
             fc::sha256 open_ver;
+            uint64_t count = 0;
 
             fc::raw::unpack(ds, _next_id);
             fc::raw::unpack(ds, open_ver);
             FC_ASSERT( open_ver == get_object_version(), "Incompatible Version, the serialization of objects in this index has changed" );
-            try {
-               vector<char> tmp;
-               while( true ) 
-               {
-                  fc::raw::unpack( ds, tmp );
-                  load( tmp );
-               }
-            } catch ( const fc::exception&  ){}
+            fc::raw::unpack(ds, count);
+            FC_ASSERT( count <= ds.remaining(), "Object count ${c} does not fit in ${db}", ("c",count)("db",db) );
+
+            vector<object_type> objects( count );
+            for( auto& o : objects )
+               fc::raw::unpack( ds, o );
+            for( auto& o : objects )
+            {
+               const auto& result = DerivedIndex::insert( std::move( o ) );
+               for( const auto& item : _sindex )
+                  item->object_inserted( result );
+            }
+            _unsaved_changes = false;
          }
 
          virtual void save( const path& db ) override 
@@ -251,11 +273,18 @@ namespace graphene { namespace db {
             auto ver  = get_object_version();
             fc::raw::pack( out, _next_id );
             fc::raw::pack( out, ver );
+            const auto count_pos = out.tellp();
+            uint64_t count = 0;
+            fc::raw::pack( out, count );
             this->inspect_all_objects( [&]( const object& o ) {
-                auto vec = fc::raw::pack( static_cast<const object_type&>(o) );
-                auto packed_vec = fc::raw::pack( vec );
-                out.write( packed_vec.data(), packed_vec.size() );
+                fc::raw::pack( out, static_cast<const object_type&>(o) );
+                ++count;
             });
+            out.seekp( count_pos );
+            fc::raw::pack( out, count );
+            out.close();
+            FC_ASSERT( out, "Could not write index file", ("db",db) );
+            _unsaved_changes = false;
          }
 
          virtual const object&  load( const std::vector<char>& data )override
@@ -263,12 +292,23 @@ namespace graphene { namespace db {
             const auto& result = DerivedIndex::insert( fc::raw::unpack<object_type>( data ) );
             for( const auto& item : _sindex )
                item->object_inserted( result );
+            _unsaved_changes = true;
             return result;
          }
 
+         virtual const object&  insert( object&& obj )override
+         {
+            _unsaved_changes = true;
+            const auto& result = DerivedIndex::insert( std::move( obj ) );
+            // Objects restored by undo have to be seen by the secondary indexes too
+            for( const auto& item : _sindex )
+               item->object_inserted( result );
+            return result;
+         }
 
          virtual const object&  create(const std::function<void(object&)>& constructor )override
          {
+            _unsaved_changes = true;
             const auto& result = DerivedIndex::create( constructor );
             for( const auto& item : _sindex )
                item->object_inserted( result );
@@ -278,6 +318,7 @@ namespace graphene { namespace db {
 
          virtual void  remove( const object& obj ) override
          {
+            _unsaved_changes = true;
             for( const auto& item : _sindex )
                item->object_removed( obj );
             on_remove(obj);
@@ -286,6 +327,7 @@ namespace graphene { namespace db {
 
          virtual void modify( const object& obj, const std::function<void(object&)>& m )override
          {
+            _unsaved_changes = true;
             save_undo( obj );
             for( const auto& item : _sindex )
                item->about_to_modify( obj );
@@ -295,6 +337,43 @@ namespace graphene { namespace db {
             on_modify( obj );
          }
 
+         /**
+          * Statically dispatched versions of create, modify and remove for callers that know the concrete index type.
+          * The callback is inlined instead of going through a std::function.
+          */
+         template<typename Constructor>
+         const object_type& direct_create( const Constructor& constructor )
+         {
+            _unsaved_changes = true;
+            const auto& result = DerivedIndex::direct_create( constructor );
+            for( const auto& item : _sindex )
+               item->object_inserted( result );
+            on_add( result );
+            return result;
+         }
+
+         template<typename Lambda>
+         void direct_modify( const object_type& obj, const Lambda& m )
+         {
+            _unsaved_changes = true;
+            save_undo( obj );
+            for( const auto& item : _sindex )
+               item->about_to_modify( obj );
+            DerivedIndex::direct_modify( obj, m );
+            for( const auto& item : _sindex )
+               item->object_modified( obj );
+            on_modify( obj );
+         }
+
+         void direct_remove( const object_type& obj )
+         {
+            _unsaved_changes = true;
+            for( const auto& item : _sindex )
+               item->object_removed( obj );
+            on_remove( obj );
+            DerivedIndex::remove( obj );
+         }
+
          virtual void add_observer( const shared_ptr<index_observer>& o ) override
          {
             _observers.emplace_back( o );
@@ -320,6 +399,7 @@ namespace graphene { namespace db {
 
       private:
          object_id_type _next_id;
+         bool           _unsaved_changes = true;
    };
 
 } } // graphene::db
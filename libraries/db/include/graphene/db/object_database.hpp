@@ -47,7 +47,7 @@ namespace graphene { namespace db {
          void open(const fc::path& data_dir);
 
          /**
-          * Saves the complete state of the object_database to disk, this could take a while
+          * Saves the state of the object_database to disk, writing only the indexes that changed since the last flush
           */
          void flush();
          void wipe(const fc::path& data_dir); // remove from disk
@@ -91,6 +91,23 @@ namespace graphene { namespace db {
             get_mutable_index(obj.id).modify(obj,m);
          }
 
+         /**
+          * Statically dispatched create, modify and remove, see primary_index::direct_modify. IndexType must be the
+          * type the index was registered with, i.e. add_index< primary_index<IndexType> >().
+          */
+         template<typename IndexType, typename Constructor>
+         const typename IndexType::object_type& direct_create( const Constructor& constructor ) {
+            return get_mutable_index_type< primary_index<IndexType> >().direct_create( constructor );
+         }
+         template<typename IndexType, typename Lambda>
+         void direct_modify( const typename IndexType::object_type& obj, const Lambda& m ) {
+            get_mutable_index_type< primary_index<IndexType> >().direct_modify( obj, m );
+         }
+         template<typename IndexType>
+         void direct_remove( const typename IndexType::object_type& obj ) {
+            get_mutable_index_type< primary_index<IndexType> >().direct_remove( obj );
+         }
+
          ///@}
 
          template<typename T>
@@ -157,6 +174,7 @@ namespace graphene { namespace db {
          index& get_mutable_index(uint8_t space_id, uint8_t type_id);
 
      private:
+         void mark_all_unsaved();
 
          friend class base_primary_index;
          friend class undo_database;
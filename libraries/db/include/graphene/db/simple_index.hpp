@@ -59,6 +59,30 @@ namespace graphene { namespace db {
             modify_callback( *_objects[obj.id.instance()] );
          }
 
+         /** Same as create, but the constructor is called directly instead of through a std::function */
+         template<typename Constructor>
+         const T& direct_create( const Constructor& constructor )
+         {
+             auto id = get_next_id();
+             auto instance = id.instance();
+             if( instance >= _objects.size() ) _objects.resize( instance + 1 );
+             T* item = new T;
+             _objects[instance].reset( item );
+             item->id = id;
+             constructor( *item );
+             item->id = id; // just in case it changed
+             use_next_id();
+             return *item;
+         }
+
+         /** Same as modify, but the callback is called directly instead of through a std::function */
+         template<typename Lambda>
+         void direct_modify( const T& obj, const Lambda& m )
+         {
+            assert( obj.id.instance() < _objects.size() );
+            m( static_cast<T&>( *_objects[obj.id.instance()] ) );
+         }
+
          virtual const object& insert( object&& obj )override
          {
             auto instance = obj.id.instance();
@@ -23,7 +23,11 @@
  */
 #pragma once
 #include <graphene/db/object.hpp>
+#include <algorithm>
+#include <cstddef>
 #include <deque>
+#include <unordered_map>
+#include <unordered_set>
 #include <fc/exception/exception.hpp>
 
 namespace graphene { namespace db {
@@ -32,12 +36,90 @@ namespace graphene { namespace db {
    using fc::flat_set;
    class object_database;
 
+   /**
+    * @class undo_arena
+    * @brief bump allocator for the object copies and container nodes of one undo_state
+    *
+    * Nothing is freed individually, all memory is released at once when the arena is destroyed. When undo states are
+    * merged, the arena of the newer state is spliced into the older one together with the objects moved over.
+    */
+   class undo_arena
+   {
+      public:
+         undo_arena() = default;
+         undo_arena( const undo_arena& ) = delete;
+         undo_arena& operator=( const undo_arena& ) = delete;
+
+         void* allocate( size_t size, size_t alignment );
+         /** takes over all memory of other, which must outlive nothing allocated from it */
+         void  splice( undo_arena& other );
+
+      private:
+         std::vector< std::unique_ptr<char[]> > _blocks;
+         size_t                                 _block_size = 0;
+         size_t                                 _used = 0;
+   };
+
+   template<typename T>
+   class undo_arena_allocator
+   {
+      public:
+         typedef T value_type;
+
+         undo_arena_allocator( undo_arena& arena ) : _arena( &arena ) {}
+         template<typename U>
+         undo_arena_allocator( const undo_arena_allocator<U>& other ) : _arena( other._arena ) {}
+
+         T*   allocate( size_t n )  { return static_cast<T*>( _arena->allocate( n * sizeof(T), alignof(T) ) ); }
+         void deallocate( T*, size_t ) {}
+
+         template<typename U>
+         bool operator == ( const undo_arena_allocator<U>& other )const { return _arena == other._arena; }
+         template<typename U>
+         bool operator != ( const undo_arena_allocator<U>& other )const { return _arena != other._arena; }
+
+      private:
+         template<typename U> friend class undo_arena_allocator;
+         undo_arena* _arena;
+   };
+
+   /** destroys an object copy living in an undo_arena, the memory is reclaimed with the arena */
+   struct undo_object_deleter
+   {
+      void operator()( object* obj )const { obj->~object(); }
+   };
+   typedef std::unique_ptr<object, undo_object_deleter> undo_object_ptr;
+
+   template<typename T>
+   using undo_map = unordered_map< object_id_type, T, std::hash<object_id_type>, std::equal_to<object_id_type>,
+                                   undo_arena_allocator< std::pair<const object_id_type, T> > >;
+   typedef std::unordered_set< object_id_type, std::hash<object_id_type>, std::equal_to<object_id_type>,
+                               undo_arena_allocator<object_id_type> > undo_id_set;
+
    struct undo_state
    {
-      unordered_map<object_id_type, unique_ptr<object> > old_values;
-      unordered_map<object_id_type, object_id_type>      old_index_next_ids;
-      std::unordered_set<object_id_type>                 new_ids;
-      unordered_map<object_id_type, unique_ptr<object> > removed;
+      undo_state()
+      : old_values( undo_map<undo_object_ptr>::allocator_type( arena ) ),
+        old_index_next_ids( undo_map<object_id_type>::allocator_type( arena ) ),
+        new_ids( undo_id_set::allocator_type( arena ) ),
+        removed( undo_map<undo_object_ptr>::allocator_type( arena ) )
+      {}
+      undo_state( const undo_state& ) = delete;
+      undo_state& operator=( const undo_state& ) = delete;
+
+      /** copies obj into this state's arena */
+      undo_object_ptr copy( const object& obj )
+      {
+         return undo_object_ptr( obj.clone_into( arena.allocate( obj.object_size(), alignof(std::max_align_t) ) ) );
+      }
+
+      // Declared first so that it is destroyed after the containers and objects allocated from it.
+      undo_arena                      arena;
+
+      undo_map<undo_object_ptr>       old_values;
+      undo_map<object_id_type>        old_index_next_ids;
+      undo_id_set                     new_ids;
+      undo_map<undo_object_ptr>       removed;
    };
 
 
@@ -25,6 +25,7 @@
 
 #include <fc/io/raw.hpp>
 #include <fc/container/flat.hpp>
+#include <fc/time.hpp>
 #include <fc/uint128.hpp>
 
 namespace graphene { namespace db {
@@ -68,23 +69,39 @@ index& object_database::get_mutable_index(uint8_t space_id, uint8_t type_id)
    return *idx;
 }
 
+/**
+ * Only indexes that changed since they were last opened or saved are written, each to a temporary file that is then
+ * renamed over the previous one. The lock directory is held for the whole flush, so a flush that does not complete
+ * leaves a locked object_database behind, which is ignored on open.
+ */
 void object_database::flush()
 {
 //   ilog("Save object_database in ${d}", ("d", _data_dir));
-   fc::create_directories( _data_dir / "object_database.tmp" / "lock" );
+   const auto start = fc::time_point::now();
+   const fc::path dir = _data_dir / "object_database";
+   fc::create_directories( dir / "lock" );
+   uint32_t saved = 0;
    for( uint32_t space = 0; space < _index.size(); ++space )
    {
-      fc::create_directories( _data_dir / "object_database.tmp" / fc::to_string(space) );
+      fc::create_directories( dir / fc::to_string(space) );
       const auto types = _index[space].size();
       for( uint32_t type = 0; type  <  types; ++type )
-         if( _index[space][type] )
-            _index[space][type]->save( _data_dir / "object_database.tmp" / fc::to_string(space)/fc::to_string(type) );
+      {
+         if( !_index[space][type] || !_index[space][type]->has_unsaved_changes() )
+            continue;
+         const auto index_start = fc::time_point::now();
+         const fc::path file = dir / fc::to_string(space) / fc::to_string(type);
+         const fc::path tmp_file = dir / fc::to_string(space) / ( fc::to_string(type) + ".tmp" );
+         _index[space][type]->save( tmp_file );
+         fc::rename( tmp_file, file );
+         ++saved;
+         dlog( "Saved index ${s}.${t} in ${ms} ms",
+               ("s",space)("t",type)("ms",(fc::time_point::now() - index_start).count() / 1000) );
+      }
    }
-   fc::remove_all( _data_dir / "object_database.tmp" / "lock" );
-   if( fc::exists( _data_dir / "object_database" ) )
-      fc::rename( _data_dir / "object_database", _data_dir / "object_database.old" );
-   fc::rename( _data_dir / "object_database.tmp", _data_dir / "object_database" );
-   fc::remove_all( _data_dir / "object_database.old" );
+   fc::remove_all( dir / "lock" );
+   ilog( "Saved ${n} changed indexes of object_database in ${ms} ms",
+         ("n",saved)("ms",(fc::time_point::now() - start).count() / 1000) );
 }
 
 void object_database::wipe(const fc::path& data_dir)
@@ -92,23 +109,41 @@ void object_database::wipe(const fc::path& data_dir)
    close();
    ilog("Wiping object database...");
    fc::remove_all(data_dir / "object_database");
+   mark_all_unsaved();
    ilog("Done wiping object databse.");
 }
 
+void object_database::mark_all_unsaved()
+{
+   for( auto& space : _index )
+      for( auto& idx : space )
+         if( idx )
+            idx->mark_unsaved();
+}
+
 void object_database::open(const fc::path& data_dir)
 { try {
    _data_dir = data_dir;
    if( fc::exists( _data_dir / "object_database" / "lock" ) )
    {
        wlog("Ignoring locked object_database");
+       // Unchanged indexes are not rewritten by flush, so files of an incomplete flush must not survive.
+       fc::remove_all( _data_dir / "object_database" );
+       mark_all_unsaved();
        return;
    }
    ilog("Opening object database from ${d} ...", ("d", data_dir));
+   const auto start = fc::time_point::now();
    for( uint32_t space = 0; space < _index.size(); ++space )
       for( uint32_t type = 0; type  < _index[space].size(); ++type )
          if( _index[space][type] )
+         {
+            const auto index_start = fc::time_point::now();
             _index[space][type]->open( _data_dir / "object_database" / fc::to_string(space)/fc::to_string(type) );
-   ilog( "Done opening object database." );
+            dlog( "Loaded index ${s}.${t} in ${ms} ms",
+                  ("s",space)("t",type)("ms",(fc::time_point::now() - index_start).count() / 1000) );
+         }
+   ilog( "Done opening object database in ${ms} ms.", ("ms",(fc::time_point::now() - start).count() / 1000) );
 
 } FC_CAPTURE_AND_RETHROW( (data_dir) ) }
 
@@ -27,6 +27,43 @@
 
 namespace graphene { namespace db {
 
+void* undo_arena::allocate( size_t size, size_t alignment )
+{
+   const size_t max_block_size = 256 * 1024;
+   size_t offset = ( _used + alignment - 1 ) & ~( alignment - 1 );
+   if( _blocks.empty() || offset + size > _block_size )
+   {
+      if( size > max_block_size / 4 )
+      {
+         // Oversized requests get a block of their own, placed before the current block so it stays in use.
+         _blocks.emplace( _blocks.empty() ? _blocks.end() : _blocks.end() - 1, new char[size] );
+         if( _blocks.size() == 1 )
+            _used = _block_size = size;
+         return ( _blocks.size() == 1 ? _blocks.back() : _blocks[_blocks.size() - 2] ).get();
+      }
+      _block_size = std::min( std::max<size_t>( _block_size * 2, 4 * 1024 ), max_block_size );
+      _blocks.emplace_back( new char[_block_size] );
+      offset = 0;
+   }
+   _used = offset + size;
+   return _blocks.back().get() + offset;
+}
+
+void undo_arena::splice( undo_arena& other )
+{
+   // Keep our current block last so that allocation continues in it.
+   _blocks.insert( _blocks.empty() ? _blocks.end() : _blocks.end() - 1,
+                   std::make_move_iterator( other._blocks.begin() ), std::make_move_iterator( other._blocks.end() ) );
+   if( _blocks.size() == other._blocks.size() )
+   {
+      _block_size = other._block_size;
+      _used = other._used;
+   }
+   other._blocks.clear();
+   other._block_size = 0;
+   other._used = 0;
+}
+
 void undo_database::enable()  { _disabled = false; }
 void undo_database::disable() { _disabled = true; }
 
@@ -68,7 +105,7 @@ void undo_database::on_modify( const object& obj )
       return;
    auto itr =  state.old_values.find(obj.id);
    if( itr != state.old_values.end() ) return;
-   state.old_values[obj.id] = obj.clone();
+   state.old_values[obj.id] = state.copy( obj );
 }
 void undo_database::on_remove( const object& obj )
 {
@@ -89,7 +126,7 @@ void undo_database::on_remove( const object& obj )
       return;
    }
    if( state.removed.count(obj.id) ) return;
-   state.removed[obj.id] = obj.clone();
+   state.removed[obj.id] = state.copy( obj );
 }
 
 void undo_database::undo()
@@ -239,6 +276,8 @@ void undo_database::merge()
       // nop + del(was=Y) -> del(was=Y)
       prev_state.removed[obj.second->id] = std::move(obj.second);
    }
+   // The objects moved into prev_state live in state's arena.
+   prev_state.arena.splice( state.arena );
    _stack.pop_back();
    --_active_sessions;
 }
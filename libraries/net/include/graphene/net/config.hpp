@@ -81,6 +81,13 @@
 
 #define GRAPHENE_NET_MAX_BLOCKS_PER_PEER_DURING_SYNCING      200
 
+/**
+ * How many of the items most recently read from the blockchain to serve to
+ * peers, typically sync blocks, are kept in the message cache.  A block
+ * requested by several syncing peers is then read and packed only once.
+ */
+#define GRAPHENE_NET_SERVED_ITEM_CACHE_SIZE                  GRAPHENE_NET_MAX_BLOCKS_PER_PEER_DURING_SYNCING
+
 /**
  * During normal operation, how many items will be fetched from each
  * peer at a time.  This will only come into play when the network
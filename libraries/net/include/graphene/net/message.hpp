@@ -29,6 +29,9 @@
 #include <fc/crypto/ripemd160.hpp>
 #include <fc/reflect/variant.hpp>
 
+#include <cstring>
+#include <memory>
+
 namespace graphene { namespace net {
 
   /**
@@ -108,8 +111,52 @@ namespace graphene { namespace net {
      }
   };
 
+  /**
+   *  A message serialized into the bytes which are written to a connection: the header, followed by the data and
+   *  padded to a multiple of 16 bytes.  It never changes once built, so the same buffer can be shared by the message
+   *  cache and the send queues of all the peers the message goes to, instead of copying the message for each of them.
+   */
+  class shared_message
+  {
+  public:
+     explicit shared_message( const message& m ) :
+        _header( m )
+     {
+        size_t size_of_message_and_header = sizeof(message_header) + m.size;
+        _buffer.resize( 16 * ((size_of_message_and_header + 15) / 16) );
+        memcpy( _buffer.data(), (const char*)&_header, sizeof(message_header) );
+        memcpy( _buffer.data() + sizeof(message_header), m.data.data(), m.size );
+     }
 
+     const message_header&    header()const { return _header; }
+     /** the padded message, ready to be written to a connection */
+     const std::vector<char>& buffer()const { return _buffer; }
 
+     /**
+      *  Deserializes T from the data of the message, like message::as()
+      */
+     template<typename T>
+     T as()const
+     {
+         try {
+          FC_ASSERT( _header.msg_type == T::type );
+          T tmp;
+          fc::datastream<const char*> ds( _buffer.data() + sizeof(message_header), _header.size );
+          fc::raw::unpack( ds, tmp );
+          return tmp;
+         } FC_RETHROW_EXCEPTIONS( warn,
+              "error unpacking network message as a '${type}'  ${x} !=? ${msg_type}",
+              ("type", fc::get_typename<T>::name() )
+              ("x", T::type)
+              ("msg_type", _header.msg_type)
+              );
+     }
+
+  private:
+     message_header    _header;
+     std::vector<char> _buffer;
+  };
+  typedef std::shared_ptr<const shared_message> shared_message_ptr;
 
 } } // graphene::net
 
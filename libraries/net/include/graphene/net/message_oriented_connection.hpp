@@ -23,6 +23,7 @@
  */
 #pragma once
 #include <fc/network/tcp_socket.hpp>
+#include <fc/thread/thread.hpp>
 #include <graphene/net/message.hpp>
 
 namespace graphene { namespace net {
@@ -47,11 +48,15 @@ namespace graphene { namespace net {
        ~message_oriented_connection();
        fc::tcp_socket& get_socket();
 
+       /** makes the read loop and every other operation on the socket run on the given thread instead of the current
+        * one, must be called before accept() or connect_to() */
+       void set_read_thread(fc::thread* read_thread);
        void accept();
        void bind(const fc::ip::endpoint& local_endpoint);
        void connect_to(const fc::ip::endpoint& remote_endpoint);
 
        void send_message(const message& message_to_send);
+       void send_message(const shared_message_ptr& message_to_send);
        void close_connection();
        void destroy_connection();
 
@@ -40,9 +40,13 @@
 #include <boost/multi_index/sequenced_index.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 
+#include <atomic>
+#include <functional>
+#include <mutex>
 #include <queue>
 #include <boost/container/deque.hpp>
 #include <fc/thread/future.hpp>
+#include <fc/thread/thread.hpp>
 
 namespace graphene { namespace net
   {
@@ -61,14 +65,53 @@ namespace graphene { namespace net
       node_id_t        requesting_peer;
     };
 
+    /* threads which read, decrypt and decode the messages of peers, leaving only their
+     * handling to the node's thread.  The counters are the number of messages in each
+     * stage, updated from all the threads.
+     */
+    class message_processing_pool
+    {
+    public:
+      explicit message_processing_pool(uint32_t thread_count);
+
+      uint32_t           thread_count() const { return (uint32_t)_threads.size(); }
+      /** the thread which should run the read loop of the next connection */
+      fc::thread*        next_thread();
+      fc::variant_object get_statistics() const;
+
+      void update_max_messages_waiting();
+
+      std::atomic<uint32_t> connections;           // read loops running on the pool's threads
+      std::atomic<uint32_t> messages_decoding;     // being hashed and deserialized on a pool thread
+      std::atomic<uint32_t> messages_waiting;      // decoded, waiting to be handled on the node's thread
+      std::atomic<uint32_t> messages_handling;     // being handled on the node's thread
+      std::atomic<uint32_t> max_messages_waiting;
+      std::atomic<uint64_t> messages_handled;
+    private:
+      std::vector<std::shared_ptr<fc::thread> > _threads;
+      std::atomic<uint32_t> _next_thread;
+    };
+    typedef std::shared_ptr<message_processing_pool> message_processing_pool_ptr;
+
+    /* the payload of a message which has already been deserialized off the node's thread, if it is a block or a
+     * transaction.  Both are empty for the other messages and for messages read on the node's thread.
+     */
+    struct decoded_message
+    {
+      std::shared_ptr<const block_message> block;
+      std::shared_ptr<const trx_message>   trx;
+    };
+
     class peer_connection;
     class peer_connection_delegate
     {
     public:
       virtual void on_message(peer_connection* originating_peer,
-                              const message& received_message) = 0;
+                              const message& received_message,
+                              const message_hash_type& message_hash,
+                              const decoded_message& decoded) = 0;
       virtual void on_connection_closed(peer_connection* originating_peer) = 0;
-      virtual message get_message_for_item(const item_id& item) = 0;
+      virtual shared_message_ptr get_message_for_item(const item_id& item) = 0;
     };
 
     class peer_connection;
@@ -108,6 +151,7 @@ namespace graphene { namespace net
     private:
       peer_connection_delegate*      _node;
       fc::optional<fc::ip::endpoint> _remote_endpoint;
+      message_processing_pool_ptr    _message_processing_pool;
       message_oriented_connection    _message_connection;
 
       /* a base class for messages on the queue, to hide the fact that some
@@ -123,7 +167,7 @@ namespace graphene { namespace net
           enqueue_time(enqueue_time)
         {}
 
-        virtual message get_message(peer_connection_delegate* node) = 0;
+        virtual shared_message_ptr get_message(peer_connection_delegate* node) = 0;
         /** returns roughly the number of bytes of memory the message is consuming while
          * it is sitting on the queue
          */
@@ -132,7 +176,8 @@ namespace graphene { namespace net
       };
 
       /* when you queue up a 'real_queued_message', a full copy of the message is
-       * stored on the heap until it is sent
+       * stored on the heap until it is sent.  This is only used for messages which
+       * have the send time patched into them, the others are queued as shared messages
        */
       struct real_queued_message : queued_message
       {
@@ -145,7 +190,22 @@ namespace graphene { namespace net
           message_send_time_field_offset(message_send_time_field_offset)
         {}
 
-        message get_message(peer_connection_delegate* node) override;
+        shared_message_ptr get_message(peer_connection_delegate* node) override;
+        size_t get_size_in_queue() override;
+      };
+
+      /* when you queue up a 'shared_queued_message', the queue holds a reference to
+       * a message which has been serialized once and may be queued for other peers too
+       */
+      struct shared_queued_message : queued_message
+      {
+        shared_message_ptr message_to_send;
+
+        shared_queued_message(shared_message_ptr message_to_send) :
+          message_to_send(std::move(message_to_send))
+        {}
+
+        shared_message_ptr get_message(peer_connection_delegate* node) override;
         size_t get_size_in_queue() override;
       };
 
@@ -161,7 +221,7 @@ namespace graphene { namespace net
           item_to_send(std::move(item_to_send))
         {}
 
-        message get_message(peer_connection_delegate* node) override;
+        shared_message_ptr get_message(peer_connection_delegate* node) override;
         size_t get_size_in_queue() override;
       };
 
@@ -265,17 +325,27 @@ namespace graphene { namespace net
       fc::future<void> accept_or_connect_task_done;
 
       firewall_check_state_data *firewall_check_state;
-#ifndef NDEBUG
     private:
-      fc::thread* _thread;
+      fc::thread* _thread; // the node's thread, everything but the read loop and the socket operations runs on it
+#ifndef NDEBUG
       unsigned _send_message_queue_tasks_running; // temporary debugging
 #endif
     bool _currently_handling_message; // true while we're in the middle of handling a message from the remote system
+    std::atomic<uint32_t> _messages_waiting_for_handling; // decoded on the message processing pool, queued for the node's thread
+    class node_thread_call;
+    std::mutex _node_thread_call_mutex;
+    std::shared_ptr<node_thread_call> _node_thread_call; // the last call the read loop passed to the node's thread
+    bool _counted_in_message_processing_pool; // until destroy() has run
     private:
-      peer_connection(peer_connection_delegate* delegate);
+      peer_connection(peer_connection_delegate* delegate, message_processing_pool_ptr message_processing_pool);
       void destroy();
+      void handle_message(const message& received_message, const message_hash_type& message_hash,
+                          const decoded_message& decoded);
+      void call_on_node_thread(const std::function<void()>& call, const char* description);
     public:
-      static peer_connection_ptr make_shared(peer_connection_delegate* delegate); // use this instead of the constructor
+      /** use this instead of the constructor.  If a pool is given, the connection's messages are read and decoded on one of its threads */
+      static peer_connection_ptr make_shared(peer_connection_delegate* delegate,
+                                             message_processing_pool_ptr message_processing_pool = message_processing_pool_ptr());
       virtual ~peer_connection();
 
       fc::tcp_socket& get_socket();
@@ -287,6 +357,7 @@ namespace graphene { namespace net
 
       void send_queueable_message(std::unique_ptr<queued_message>&& message_to_send);
       void send_message(const message& message_to_send, size_t message_send_time_field_offset = (size_t)-1);
+      void send_message(const shared_message_ptr& message_to_send);
       void send_item(const item_id& item_to_send);
       void close_connection();
       void destroy_connection();
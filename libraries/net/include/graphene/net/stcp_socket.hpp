@@ -67,7 +67,9 @@ class stcp_socket : public virtual fc::iostream
     fc::aes_encoder      _send_aes;
     fc::aes_decoder      _recv_aes;
     std::shared_ptr<char> _read_buffer;
+    size_t                _read_buffer_length;
     std::shared_ptr<char> _write_buffer;
+    size_t                _write_buffer_length;
 #ifndef NDEBUG
     bool _read_buffer_in_use;
     bool _write_buffer_in_use;
@@ -32,6 +32,11 @@
 #include <graphene/net/stcp_socket.hpp>
 #include <graphene/net/config.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+
 #ifdef DEFAULT_LOGGER
 # undef DEFAULT_LOGGER
 #endif
@@ -53,12 +58,16 @@ namespace graphene { namespace net {
       message_oriented_connection_delegate *_delegate;
       stcp_socket _sock;
       fc::future<void> _read_loop_done;
-      uint64_t _bytes_received;
+      fc::thread* _read_thread;
+      std::vector<fc::future<void> > _socket_operations; // posted to the read thread by the node's thread
+      std::atomic<uint64_t> _bytes_received;
       uint64_t _bytes_sent;
+      fc::time_point _last_message_sent_time;
 
+      // written by the read loop, which may be running on another thread
+      mutable std::mutex _read_state_mutex;
       fc::time_point _connected_time;
       fc::time_point _last_message_received_time;
-      fc::time_point _last_message_sent_time;
 
       bool _send_message_in_progress;
 
@@ -68,8 +77,10 @@ namespace graphene { namespace net {
 
       void read_loop();
       void start_read_loop();
+      void run_on_read_thread(const std::function<void()>& operation, const char* description);
     public:
       fc::tcp_socket& get_socket();
+      void set_read_thread(fc::thread* read_thread);
       void accept();
       void connect_to(const fc::ip::endpoint& remote_endpoint);
       void bind(const fc::ip::endpoint& local_endpoint);
@@ -78,7 +89,7 @@ namespace graphene { namespace net {
                                        message_oriented_connection_delegate* delegate = nullptr);
       ~message_oriented_connection_impl();
 
-      void send_message(const message& message_to_send);
+      void send_message(const shared_message_ptr& message_to_send);
       void close_connection();
       void destroy_connection();
 
@@ -87,7 +98,7 @@ namespace graphene { namespace net {
 
       fc::time_point get_last_message_sent_time() const;
       fc::time_point get_last_message_received_time() const;
-      fc::time_point get_connection_time() const { return _connected_time; }
+      fc::time_point get_connection_time() const;
       fc::sha512 get_shared_secret() const;
     };
 
@@ -95,6 +106,7 @@ namespace graphene { namespace net {
                                                                        message_oriented_connection_delegate* delegate)
     : _self(self),
       _delegate(delegate),
+      _read_thread(nullptr),
       _bytes_received(0),
       _bytes_sent(0),
       _send_message_in_progress(false)
@@ -115,37 +127,77 @@ namespace graphene { namespace net {
       return _sock.get_socket();
     }
 
+    void message_oriented_connection_impl::set_read_thread(fc::thread* read_thread)
+    {
+      VERIFY_CORRECT_THREAD();
+      assert(!_read_loop_done.valid());
+      _read_thread = read_thread;
+    }
+
     void message_oriented_connection_impl::accept()
     {
       VERIFY_CORRECT_THREAD();
-      _sock.accept();
-      assert(!_read_loop_done.valid()); // check to be sure we never launch two read loops
-      _read_loop_done = fc::async([=](){ read_loop(); }, "message read_loop");
+      run_on_read_thread([this](){ _sock.accept(); }, "accept connection");
+      start_read_loop();
     }
 
     void message_oriented_connection_impl::connect_to(const fc::ip::endpoint& remote_endpoint)
     {
       VERIFY_CORRECT_THREAD();
-      _sock.connect_to(remote_endpoint);
+      run_on_read_thread([this, remote_endpoint](){ _sock.connect_to(remote_endpoint); }, "connect to peer");
+      start_read_loop();
+    }
+
+    void message_oriented_connection_impl::start_read_loop()
+    {
+      VERIFY_CORRECT_THREAD();
       assert(!_read_loop_done.valid()); // check to be sure we never launch two read loops
-      _read_loop_done = fc::async([=](){ read_loop(); }, "message read_loop");
+      if (_read_thread)
+        _read_loop_done = _read_thread->async([=](){ read_loop(); }, "message read_loop");
+      else
+        _read_loop_done = fc::async([=](){ read_loop(); }, "message read_loop");
     }
 
     void message_oriented_connection_impl::bind(const fc::ip::endpoint& local_endpoint)
     {
       VERIFY_CORRECT_THREAD();
-      _sock.bind(local_endpoint);
+      run_on_read_thread([this, local_endpoint](){ _sock.bind(local_endpoint); }, "bind connection");
+    }
+
+    void message_oriented_connection_impl::run_on_read_thread(const std::function<void()>& operation, const char* description)
+    {
+      VERIFY_CORRECT_THREAD();
+      // The socket isn't safe to use from two threads at once, so once the read loop runs on another thread, every
+      // operation on the socket runs there too, as another task beside the read loop.  Waiting for it only yields
+      // this task: the read loop never blocks its thread, it waits on fc futures as well
+      if (!_read_thread || _read_thread->is_current())
+      {
+        operation();
+        return;
+      }
+      _socket_operations.erase(std::remove_if(_socket_operations.begin(), _socket_operations.end(),
+                                              [](const fc::future<void>& done) { return done.ready(); }),
+                               _socket_operations.end());
+      // if the waiting task is canceled, the operation still runs, and destroy_connection() waits for it
+      fc::future<void> operation_done = _read_thread->async(operation, description);
+      _socket_operations.push_back(operation_done);
+      operation_done.wait();
     }
 
 
     void message_oriented_connection_impl::read_loop()
     {
-      VERIFY_CORRECT_THREAD();
+#ifndef NDEBUG
+      assert((_read_thread ? _read_thread : _thread)->is_current());
+#endif
       const int BUFFER_SIZE = 16;
       const int LEFTOVER = BUFFER_SIZE - sizeof(message_header);
       static_assert(BUFFER_SIZE >= sizeof(message_header), "insufficient buffer");
 
-      _connected_time = fc::time_point::now();
+      {
+        std::lock_guard<std::mutex> guard(_read_state_mutex);
+        _connected_time = fc::time_point::now();
+      }
 
       fc::oexception exception_to_rethrow;
       bool call_on_connection_closed = false;
@@ -172,7 +224,10 @@ namespace graphene { namespace net {
           }
           m.data.resize(m.size); // truncate off the padding bytes
 
-          _last_message_received_time = fc::time_point::now();
+          {
+            std::lock_guard<std::mutex> guard(_read_state_mutex);
+            _last_message_received_time = fc::time_point::now();
+          }
 
           try
           {
@@ -226,7 +281,7 @@ namespace graphene { namespace net {
         throw *exception_to_rethrow;
     }
 
-    void message_oriented_connection_impl::send_message(const message& message_to_send)
+    void message_oriented_connection_impl::send_message(const shared_message_ptr& message_to_send)
     {
       VERIFY_CORRECT_THREAD();
 #if 0 // this gets too verbose
@@ -255,17 +310,16 @@ namespace graphene { namespace net {
 
       try
       {
-        size_t size_of_message_and_header = sizeof(message_header) + message_to_send.size;
-        if( message_to_send.size > MAX_MESSAGE_SIZE )
+        if( message_to_send->header().size > MAX_MESSAGE_SIZE )
            elog("Trying to send a message larger than MAX_MESSAGE_SIZE. This probably won't work...");
-        //pad the message we send to a multiple of 16 bytes
-        size_t size_with_padding = 16 * ((size_of_message_and_header + 15) / 16);
-        std::unique_ptr<char[]> padded_message(new char[size_with_padding]);
-        memcpy(padded_message.get(), (char*)&message_to_send, sizeof(message_header));
-        memcpy(padded_message.get() + sizeof(message_header), message_to_send.data.data(), message_to_send.size );
-        _sock.write(padded_message.get(), size_with_padding);
-        _sock.flush();
-        _bytes_sent += size_with_padding;
+        // the message is already padded to a multiple of 16 bytes.  The write holds its own reference to it, as it
+        // outlives this call if the sending task is canceled
+        run_on_read_thread([this, message_to_send](){
+          const std::vector<char>& padded_message = message_to_send->buffer();
+          _sock.write(padded_message.data(), padded_message.size());
+          _sock.flush();
+        }, "send message");
+        _bytes_sent += message_to_send->buffer().size();
         _last_message_sent_time = fc::time_point::now();
       } FC_RETHROW_EXCEPTIONS( warn, "unable to send message" );
     }
@@ -273,7 +327,7 @@ namespace graphene { namespace net {
     void message_oriented_connection_impl::close_connection()
     {
       VERIFY_CORRECT_THREAD();
-      _sock.close();
+      run_on_read_thread([this](){ _sock.close(); }, "close connection");
     }
 
     void message_oriented_connection_impl::destroy_connection()
@@ -281,8 +335,16 @@ namespace graphene { namespace net {
       VERIFY_CORRECT_THREAD();
 
       fc::optional<fc::ip::endpoint> remote_endpoint;
-      if (_sock.get_socket().is_open())
-        remote_endpoint = _sock.get_socket().remote_endpoint();
+      try
+      {
+        run_on_read_thread([this, &remote_endpoint](){
+          if (_sock.get_socket().is_open())
+            remote_endpoint = _sock.get_socket().remote_endpoint();
+        }, "get remote endpoint");
+      }
+      catch ( const fc::exception& )
+      {
+      }
       ilog( "in destroy_connection() for ${endpoint}", ("endpoint", remote_endpoint) );
 
       if (_send_message_in_progress)
@@ -302,6 +364,24 @@ namespace graphene { namespace net {
       {
         wlog( "Exception thrown while canceling message_oriented_connection's read_loop, ignoring" );
       }
+
+      // operations whose tasks were canceled while waiting for them are still using the socket
+      for (fc::future<void>& operation_done : _socket_operations)
+      {
+        try
+        {
+          operation_done.wait();
+        }
+        catch ( const fc::exception& e )
+        {
+          wlog( "Exception thrown by an operation on message_oriented_connection's socket, ignoring: ${e}", ("e",e) );
+        }
+        catch (...)
+        {
+          wlog( "Exception thrown by an operation on message_oriented_connection's socket, ignoring" );
+        }
+      }
+      _socket_operations.clear();
     }
 
     uint64_t message_oriented_connection_impl::get_total_bytes_sent() const
@@ -325,9 +405,17 @@ namespace graphene { namespace net {
     fc::time_point message_oriented_connection_impl::get_last_message_received_time() const
     {
       VERIFY_CORRECT_THREAD();
+      std::lock_guard<std::mutex> guard(_read_state_mutex);
       return _last_message_received_time;
     }
 
+    fc::time_point message_oriented_connection_impl::get_connection_time() const
+    {
+      VERIFY_CORRECT_THREAD();
+      std::lock_guard<std::mutex> guard(_read_state_mutex);
+      return _connected_time;
+    }
+
     fc::sha512 message_oriented_connection_impl::get_shared_secret() const
     {
       VERIFY_CORRECT_THREAD();
@@ -351,6 +439,11 @@ namespace graphene { namespace net {
     return my->get_socket();
   }
 
+  void message_oriented_connection::set_read_thread(fc::thread* read_thread)
+  {
+    my->set_read_thread(read_thread);
+  }
+
   void message_oriented_connection::accept()
   {
     my->accept();
@@ -367,6 +460,11 @@ namespace graphene { namespace net {
   }
 
   void message_oriented_connection::send_message(const message& message_to_send)
+  {
+    my->send_message(std::make_shared<const shared_message>(message_to_send));
+  }
+
+  void message_oriented_connection::send_message(const shared_message_ptr& message_to_send)
   {
     my->send_message(message_to_send);
   }
@@ -134,8 +134,8 @@ namespace graphene { namespace net {
       struct block_clock_index{};
       struct message_info
       {
-        message_hash_type message_hash;
-        message           message_body;
+        message_hash_type  message_hash;
+        shared_message_ptr message_body;
         uint32_t          block_clock_when_received;
 
         // for network performance stats
@@ -143,7 +143,7 @@ namespace graphene { namespace net {
         fc::uint160_t     message_contents_hash; // hash of whatever the message contains (if it's a transaction, this is the transaction id, if it's a block, it's the block_id)
 
         message_info( const message_hash_type& message_hash,
-                      const message&           message_body,
+                      const shared_message_ptr& message_body,
                       uint32_t                 block_clock_when_received,
                       const message_propagation_data& propagation_data,
                       fc::uint160_t            message_contents_hash ) :
@@ -166,6 +166,21 @@ namespace graphene { namespace net {
 
       message_cache_container _message_cache;
 
+      struct served_item_info
+      {
+        message_hash_type  item_hash;
+        shared_message_ptr message_body;
+      };
+      typedef boost::multi_index_container
+        < served_item_info,
+            bmi::indexed_by< bmi::sequenced<>,
+                             bmi::ordered_unique< bmi::tag<message_hash_index>,
+                                                  bmi::member<served_item_info, message_hash_type, &served_item_info::item_hash> > >
+        > served_item_container;
+
+      /// items read from the blockchain to serve to peers, most recently served first
+      served_item_container _served_items;
+
       uint32_t block_clock;
 
     public:
@@ -173,9 +188,10 @@ namespace graphene { namespace net {
         block_clock( 0 )
       {}
       void block_accepted();
-      void cache_message( const message& message_to_cache, const message_hash_type& hash_of_message_to_cache,
+      void cache_message( const shared_message_ptr& message_to_cache, const message_hash_type& hash_of_message_to_cache,
                         const message_propagation_data& propagation_data, const fc::uint160_t& message_content_hash );
-      message get_message( const message_hash_type& hash_of_message_to_lookup );
+      void cache_served_item( const shared_message_ptr& item_to_cache, const message_hash_type& hash_of_item_to_cache );
+      shared_message_ptr get_message( const message_hash_type& hash_of_message_to_lookup );
       message_propagation_data get_message_propagation_data( const fc::uint160_t& hash_of_message_contents_to_lookup ) const;
       size_t size() const { return _message_cache.size(); }
     };
@@ -188,7 +204,7 @@ namespace graphene { namespace net {
                                                       _message_cache.get<block_clock_index>().lower_bound(block_clock - cache_duration_in_blocks ) );
     }
 
-    void blockchain_tied_message_cache::cache_message( const message& message_to_cache,
+    void blockchain_tied_message_cache::cache_message( const shared_message_ptr& message_to_cache,
                                                      const message_hash_type& hash_of_message_to_cache,
                                                      const message_propagation_data& propagation_data,
                                                      const fc::uint160_t& message_content_hash )
@@ -200,15 +216,31 @@ namespace graphene { namespace net {
                                          message_content_hash ) );
     }
 
-    message blockchain_tied_message_cache::get_message( const message_hash_type& hash_of_message_to_lookup )
+    shared_message_ptr blockchain_tied_message_cache::get_message( const message_hash_type& hash_of_message_to_lookup )
     {
       message_cache_container::index<message_hash_index>::type::const_iterator iter =
          _message_cache.get<message_hash_index>().find(hash_of_message_to_lookup );
       if( iter != _message_cache.get<message_hash_index>().end() )
         return iter->message_body;
+      served_item_container::index<message_hash_index>::type::const_iterator served_iter =
+         _served_items.get<message_hash_index>().find(hash_of_message_to_lookup );
+      if( served_iter != _served_items.get<message_hash_index>().end() )
+      {
+        _served_items.relocate( _served_items.begin(), _served_items.project<0>(served_iter) );
+        return served_iter->message_body;
+      }
       FC_THROW_EXCEPTION(  fc::key_not_found_exception, "Requested message not in cache" );
     }
 
+    void blockchain_tied_message_cache::cache_served_item( const shared_message_ptr& item_to_cache,
+                                                          const message_hash_type& hash_of_item_to_cache )
+    {
+      if( !_served_items.push_front( served_item_info{ hash_of_item_to_cache, item_to_cache } ).second )
+        return;
+      if( _served_items.size() > GRAPHENE_NET_SERVED_ITEM_CACHE_SIZE )
+        _served_items.pop_back();
+    }
+
     message_propagation_data blockchain_tied_message_cache::get_message_propagation_data( const fc::uint160_t& hash_of_message_contents_to_lookup ) const
     {
       if( hash_of_message_contents_to_lookup != fc::uint160_t() )
@@ -577,6 +609,9 @@ namespace graphene { namespace net { namespace detail {
       unsigned _maximum_number_of_sync_blocks_to_prefetch;
       unsigned _maximum_blocks_per_peer_during_syncing;
 
+      /// when set, the messages of new connections are read and decoded on its threads instead of this one
+      message_processing_pool_ptr _message_processing_pool;
+
       std::list<fc::future<void> > _handle_message_calls_in_progress;
 
       node_impl(const std::string& user_agent);
@@ -623,7 +658,9 @@ namespace graphene { namespace net { namespace detail {
       void parse_hello_user_data_for_peer( peer_connection* originating_peer, const fc::variant_object& user_data );
 
       void on_message( peer_connection* originating_peer,
-                       const message& received_message ) override;
+                       const message& received_message,
+                       const message_hash_type& message_hash,
+                       const decoded_message& decoded ) override;
 
       void on_hello_message( peer_connection* originating_peer,
                              const hello_message& hello_message_received );
@@ -685,9 +722,11 @@ namespace graphene { namespace net { namespace detail {
       void trigger_process_backlog_of_sync_blocks();
       void process_block_during_sync(peer_connection* originating_peer, const graphene::net::block_message& block_message, const message_hash_type& message_hash);
       void process_block_during_normal_operation(peer_connection* originating_peer, const graphene::net::block_message& block_message, const message_hash_type& message_hash);
-      void process_block_message(peer_connection* originating_peer, const message& message_to_process, const message_hash_type& message_hash);
+      void process_block_message(peer_connection* originating_peer, const message& message_to_process, const message_hash_type& message_hash,
+                                 const std::shared_ptr<const graphene::net::block_message>& decoded_block);
 
-      void process_ordinary_message(peer_connection* originating_peer, const message& message_to_process, const message_hash_type& message_hash);
+      void process_ordinary_message(peer_connection* originating_peer, const message& message_to_process, const message_hash_type& message_hash,
+                                    const std::shared_ptr<const graphene::net::trx_message>& decoded_trx);
 
       void start_synchronizing();
       void start_synchronizing_with_peer(const peer_connection_ptr& peer);
@@ -751,7 +790,7 @@ namespace graphene { namespace net { namespace detail {
       void                       set_total_bandwidth_limit( uint32_t upload_bytes_per_second, uint32_t download_bytes_per_second );
       void                       disable_peer_advertising();
       fc::variant_object         get_call_statistics() const;
-      message                    get_message_for_item(const item_id& item) override;
+      shared_message_ptr         get_message_for_item(const item_id& item) override;
 
       fc::variant_object         network_get_info() const;
       fc::variant_object         network_get_usage_stats() const;
@@ -1760,10 +1799,12 @@ namespace graphene { namespace net { namespace detail {
       }
     }
 
-    void node_impl::on_message( peer_connection* originating_peer, const message& received_message )
+    void node_impl::on_message( peer_connection* originating_peer,
+                                const message& received_message,
+                                const message_hash_type& message_hash,
+                                const decoded_message& decoded )
     {
       VERIFY_CORRECT_THREAD();
-      message_hash_type message_hash = received_message.id();
       dlog("handling message ${type} ${hash} size ${size} from peer ${endpoint}",
            ("type", graphene::net::core_message_type_enum(received_message.msg_type))("hash", message_hash)
            ("size", received_message.size)
@@ -1804,7 +1845,7 @@ namespace graphene { namespace net { namespace detail {
         on_closing_connection_message(originating_peer, received_message.as<closing_connection_message>());
         break;
       case core_message_type_enum::block_message_type:
-        process_block_message(originating_peer, received_message, message_hash);
+        process_block_message(originating_peer, received_message, message_hash, decoded.block);
         break;
       case core_message_type_enum::current_time_request_message_type:
         on_current_time_request_message(originating_peer, received_message.as<current_time_request_message>());
@@ -1830,7 +1871,7 @@ namespace graphene { namespace net { namespace detail {
         // to allow us to add messages in the future
         if (received_message.msg_type < core_message_type_enum::core_message_type_first ||
             received_message.msg_type > core_message_type_enum::core_message_type_last)
-          process_ordinary_message(originating_peer, received_message, message_hash);
+          process_ordinary_message(originating_peer, received_message, message_hash, decoded.trx);
         break;
       }
     }
@@ -2739,7 +2780,7 @@ namespace graphene { namespace net { namespace detail {
       }
     }
 
-    message node_impl::get_message_for_item(const item_id& item)
+    shared_message_ptr node_impl::get_message_for_item(const item_id& item)
     {
       try
       {
@@ -2749,11 +2790,13 @@ namespace graphene { namespace net { namespace detail {
       {}
       try
       {
-        return _delegate->get_item(item);
+        shared_message_ptr item_message = std::make_shared<const shared_message>(_delegate->get_item(item));
+        _message_cache.cache_served_item(item_message, item.item_hash);
+        return item_message;
       }
       catch (fc::key_not_found_exception&)
       {}
-      return item_not_available_message(item);
+      return std::make_shared<const shared_message>(message(item_not_available_message(item)));
     }
 
     void node_impl::on_fetch_items_message(peer_connection* originating_peer, const fetch_items_message& fetch_items_message_received)
@@ -2764,62 +2807,46 @@ namespace graphene { namespace net { namespace detail {
            ("type", fetch_items_message_received.item_type)
            ("endpoint", originating_peer->get_remote_endpoint()));
 
-      fc::optional<message> last_block_message_sent;
+      fc::optional<item_hash_t> last_block_sent;
 
-      std::list<message> reply_messages;
+      std::list<std::pair<item_id, shared_message_ptr>> reply_messages;
       for (const item_hash_t& item_hash : fetch_items_message_received.items_to_fetch)
       {
-        try
-        {
-          message requested_message = _message_cache.get_message(item_hash);
-          dlog("received item request for item ${id} from peer ${endpoint}, returning the item from my message cache",
-               ("endpoint", originating_peer->get_remote_endpoint())
-               ("id", requested_message.id()));
-          reply_messages.push_back(requested_message);
-          if (fetch_items_message_received.item_type == block_message_type)
-            last_block_message_sent = requested_message;
-          continue;
-        }
-        catch (fc::key_not_found_exception&)
-        {
-           // it wasn't in our local cache, that's ok ask the client
-        }
-
+        // looks in the message cache first, then reads the item from the delegate and keeps it as a served item, so
+        // a block is still packed only once when it is sent below, or to other peers syncing the same range
         item_id item_to_fetch(fetch_items_message_received.item_type, item_hash);
-        try
-        {
-          message requested_message = _delegate->get_item(item_to_fetch);
-          dlog("received item request from peer ${endpoint}, returning the item from delegate with id ${id} size ${size}",
-               ("id", requested_message.id())
-               ("size", requested_message.size)
+        shared_message_ptr requested_message = get_message_for_item(item_to_fetch);
+        if (requested_message->header().msg_type == item_not_available_message_type)
+          dlog("received item request from peer ${endpoint} but we don't have it",
                ("endpoint", originating_peer->get_remote_endpoint()));
-          reply_messages.push_back(requested_message);
-          if (fetch_items_message_received.item_type == block_message_type)
-            last_block_message_sent = requested_message;
-          continue;
-        }
-        catch (fc::key_not_found_exception&)
+        else
         {
-          reply_messages.push_back(item_not_available_message(item_to_fetch));
-          dlog("received item request from peer ${endpoint} but we don't have it",
+          dlog("received item request for item ${id} from peer ${endpoint}, returning it with size ${size}",
+               ("id", item_hash)
+               ("size", requested_message->header().size)
                ("endpoint", originating_peer->get_remote_endpoint()));
+          if (fetch_items_message_received.item_type == block_message_type)
+            last_block_sent = item_hash;
         }
+        reply_messages.emplace_back(item_to_fetch, requested_message);
       }
 
-      // if we sent them a block, update our record of the last block they've seen accordingly
-      if (last_block_message_sent)
+      // if we sent them a block, update our record of the last block they've seen accordingly (the hash of a block
+      // item is the block id)
+      if (last_block_sent)
       {
-        graphene::net::block_message block = last_block_message_sent->as<graphene::net::block_message>();
-        originating_peer->last_block_delegate_has_seen = block.block_id;
-        originating_peer->last_block_time_delegate_has_seen = _delegate->get_block_time(block.block_id);
+        originating_peer->last_block_delegate_has_seen = *last_block_sent;
+        originating_peer->last_block_time_delegate_has_seen = _delegate->get_block_time(*last_block_sent);
       }
 
-      for (const message& reply : reply_messages)
+      for (const auto& reply : reply_messages)
       {
-        if (reply.msg_type == block_message_type)
-          originating_peer->send_item(item_id(block_message_type, reply.as<graphene::net::block_message>().block_id));
+        // blocks are queued by id and taken from the message cache when they are sent, so they don't count against
+        // the queue size limit
+        if (reply.second->header().msg_type == block_message_type)
+          originating_peer->send_item(reply.first);
         else
-          originating_peer->send_message(reply);
+          originating_peer->send_message(reply.second);
       }
     }
 
@@ -3524,14 +3551,18 @@ namespace graphene { namespace net { namespace detail {
     }
     void node_impl::process_block_message(peer_connection* originating_peer,
                                           const message& message_to_process,
-                                          const message_hash_type& message_hash)
+                                          const message_hash_type& message_hash,
+                                          const std::shared_ptr<const graphene::net::block_message>& decoded_block)
     {
       VERIFY_CORRECT_THREAD();
       // find out whether we requested this item while we were synchronizing or during normal operation
       // (it's possible that we request an item during normal operation and then get kicked into sync
       // mode before we receive and process the item.  In that case, we should process the item as a normal
       // item to avoid confusing the sync code)
-      graphene::net::block_message block_message_to_process(message_to_process.as<graphene::net::block_message>());
+      std::shared_ptr<const graphene::net::block_message> block = decoded_block;
+      if (!block)
+        block = std::make_shared<const graphene::net::block_message>(message_to_process.as<graphene::net::block_message>());
+      const graphene::net::block_message& block_message_to_process = *block;
       auto item_iter = originating_peer->items_requested_from_peer.find(item_id(graphene::net::block_message_type, message_hash));
       if (item_iter != originating_peer->items_requested_from_peer.end())
       {
@@ -3701,7 +3732,7 @@ namespace graphene { namespace net { namespace detail {
         {
           // we're not connected to them, so we need to set up a connection to them
           // to test.
-          peer_connection_ptr peer_for_testing(peer_connection::make_shared(this));
+          peer_connection_ptr peer_for_testing(peer_connection::make_shared(this, _message_processing_pool));
           peer_for_testing->firewall_check_state = new firewall_check_state_data;
           peer_for_testing->firewall_check_state->endpoint_to_test = check_firewall_message_received.endpoint_to_check;
           peer_for_testing->firewall_check_state->expected_node_id = check_firewall_message_received.node_id;
@@ -3867,7 +3898,8 @@ namespace graphene { namespace net { namespace detail {
     // this just passes the message to the client, and does the bookkeeping
     // related to requesting and rebroadcasting the message.
     void node_impl::process_ordinary_message( peer_connection* originating_peer,
-                                              const message& message_to_process, const message_hash_type& message_hash )
+                                              const message& message_to_process, const message_hash_type& message_hash,
+                                              const std::shared_ptr<const graphene::net::trx_message>& decoded_trx )
     {
       VERIFY_CORRECT_THREAD();
       fc::time_point message_receive_time = fc::time_point::now();
@@ -3895,7 +3927,10 @@ namespace graphene { namespace net { namespace detail {
         {
           if (message_to_process.msg_type == trx_message_type)
           {
-            trx_message transaction_message_to_process = message_to_process.as<trx_message>();
+            std::shared_ptr<const trx_message> transaction = decoded_trx;
+            if (!transaction)
+              transaction = std::make_shared<const trx_message>(message_to_process.as<trx_message>());
+            const trx_message& transaction_message_to_process = *transaction;
             dlog("passing message containing transaction ${trx} to client", ("trx", transaction_message_to_process.trx.id()));
             _delegate->handle_transaction(transaction_message_to_process);
           }
@@ -4257,7 +4292,7 @@ namespace graphene { namespace net { namespace detail {
       VERIFY_CORRECT_THREAD();
       while ( !_accept_loop_complete.canceled() )
       {
-        peer_connection_ptr new_peer(peer_connection::make_shared(this));
+        peer_connection_ptr new_peer(peer_connection::make_shared(this, _message_processing_pool));
 
         try
         {
@@ -4682,7 +4717,7 @@ namespace graphene { namespace net { namespace detail {
                            ("endpoint", remote_endpoint));
 
       dlog("node_impl::connect_to_endpoint(${endpoint})", ("endpoint", remote_endpoint));
-      peer_connection_ptr new_peer(peer_connection::make_shared(this));
+      peer_connection_ptr new_peer(peer_connection::make_shared(this, _message_processing_pool));
       new_peer->set_remote_endpoint(remote_endpoint);
       initiate_connect_to(new_peer);
     }
@@ -4958,7 +4993,8 @@ namespace graphene { namespace net { namespace detail {
       }
       message_hash_type hash_of_item_to_broadcast = item_to_broadcast.id();
 
-      _message_cache.cache_message( item_to_broadcast, hash_of_item_to_broadcast, propagation_data, hash_of_message_contents );
+      _message_cache.cache_message( std::make_shared<const shared_message>(item_to_broadcast), hash_of_item_to_broadcast,
+                                    propagation_data, hash_of_message_contents );
       _new_inventory.insert( item_id(item_to_broadcast.msg_type, hash_of_item_to_broadcast ) );
       trigger_advertise_inventory_loop();
     }
@@ -5011,6 +5047,15 @@ namespace graphene { namespace net { namespace detail {
         _maximum_number_of_sync_blocks_to_prefetch = params["maximum_number_of_sync_blocks_to_prefetch"].as<uint32_t>();
       if (params.contains("maximum_blocks_per_peer_during_syncing"))
         _maximum_blocks_per_peer_during_syncing = params["maximum_blocks_per_peer_during_syncing"].as<uint32_t>();
+      if (params.contains("message_processing_threads"))
+      {
+        // connections which are already open keep using the pool they were created with
+        uint32_t message_processing_threads = params["message_processing_threads"].as<uint32_t>();
+        if (message_processing_threads == 0)
+          _message_processing_pool.reset();
+        else if (!_message_processing_pool || _message_processing_pool->thread_count() != message_processing_threads)
+          _message_processing_pool = std::make_shared<message_processing_pool>(message_processing_threads);
+      }
 
       _desired_number_of_connections = std::min(_desired_number_of_connections, _maximum_number_of_connections);
 
@@ -5030,6 +5075,7 @@ namespace graphene { namespace net { namespace detail {
       result["maximum_number_of_blocks_to_handle_at_one_time"] = _maximum_number_of_blocks_to_handle_at_one_time;
       result["maximum_number_of_sync_blocks_to_prefetch"] = _maximum_number_of_sync_blocks_to_prefetch;
       result["maximum_blocks_per_peer_during_syncing"] = _maximum_blocks_per_peer_during_syncing;
+      result["message_processing_threads"] = _message_processing_pool ? _message_processing_pool->thread_count() : 0;
       return result;
     }
 
@@ -5098,6 +5144,8 @@ namespace graphene { namespace net { namespace detail {
       info["node_public_key"] = _node_public_key;
       info["node_id"] = _node_id;
       info["firewalled"] = _is_firewalled;
+      if (_message_processing_pool)
+        info["message_processing"] = _message_processing_pool->get_statistics();
       return info;
     }
     fc::variant_object node_impl::network_get_usage_stats() const
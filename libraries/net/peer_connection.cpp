@@ -28,9 +28,13 @@
 #include <graphene/chain/protocol/fee_schedule.hpp>
 
 #include <fc/thread/thread.hpp>
+#include <fc/variant_object.hpp>
+#include <fc/string.hpp>
 
 #include <boost/scope_exit.hpp>
 
+#include <mutex>
+
 #ifdef DEFAULT_LOGGER
 # undef DEFAULT_LOGGER
 #endif
@@ -44,7 +48,115 @@
 
 namespace graphene { namespace net
   {
-    message peer_connection::real_queued_message::get_message(peer_connection_delegate*)
+    namespace
+    {
+      /* counts a message in a stage of the message_processing_pool until it leaves it or goes out of scope */
+      struct stage_counter
+      {
+        std::atomic<uint32_t>* _stage;
+        explicit stage_counter(std::atomic<uint32_t>& stage) : _stage(&stage) { ++*_stage; }
+        ~stage_counter() { leave(); }
+        void leave() { if (_stage) { --*_stage; _stage = nullptr; } }
+      };
+    }
+
+    /* the state of a call which a read loop on the message processing pool passed to the node's thread.  If the read
+     * loop is canceled, the call must not start any more, and if it has already started, destroy() waits for it to
+     * finish, as it is using the connection.  A canceled fc task can't wait on a future any more, so the read loop
+     * doesn't wait itself, it leaves that to destroy() on the node's thread.
+     */
+    class peer_connection::node_thread_call
+    {
+    public:
+      node_thread_call() :
+        _done(new fc::promise<void>("node_thread_call")),
+        _started(false),
+        _finished(false),
+        _canceled(false)
+      {}
+
+      /** @return false if the read loop has been canceled, and the call must not run */
+      bool start()
+      {
+        std::lock_guard<std::mutex> guard(_mutex);
+        if (_canceled)
+          return false;
+        _started = true;
+        return true;
+      }
+      void finish()
+      {
+        {
+          std::lock_guard<std::mutex> guard(_mutex);
+          if (_finished)
+            return;
+          _finished = true;
+        }
+        _done->set_value();
+      }
+      /** stops the call from starting, @return a promise which is set once it can no longer be running */
+      fc::promise<void>::ptr cancel()
+      {
+        bool finished_now = false;
+        {
+          std::lock_guard<std::mutex> guard(_mutex);
+          _canceled = true;
+          if (!_started && !_finished)
+            finished_now = _finished = true;
+        }
+        if (finished_now)
+          _done->set_value();
+        return _done;
+      }
+    private:
+      fc::promise<void>::ptr _done;
+      std::mutex             _mutex;
+      bool                   _started;
+      bool                   _finished;
+      bool                   _canceled;
+    };
+
+    message_processing_pool::message_processing_pool(uint32_t thread_count) :
+      connections(0),
+      messages_decoding(0),
+      messages_waiting(0),
+      messages_handling(0),
+      max_messages_waiting(0),
+      messages_handled(0),
+      _next_thread(0)
+    {
+      assert(thread_count > 0);
+      for (uint32_t i = 0; i < thread_count; ++i)
+        _threads.emplace_back(std::make_shared<fc::thread>("p2p-messages-" + fc::to_string(uint64_t(i))));
+    }
+
+    fc::thread* message_processing_pool::next_thread()
+    {
+      return _threads[_next_thread++ % _threads.size()].get();
+    }
+
+    void message_processing_pool::update_max_messages_waiting()
+    {
+      uint32_t waiting = messages_waiting;
+      uint32_t max_waiting = max_messages_waiting;
+      while (waiting > max_waiting && !max_messages_waiting.compare_exchange_weak(max_waiting, waiting))
+        ;
+    }
+
+    fc::variant_object message_processing_pool::get_statistics() const
+    {
+      fc::mutable_variant_object result;
+      result["threads"] = thread_count();
+      result["connections"] = connections.load();
+      result["messages_decoding"] = messages_decoding.load();
+      result["messages_waiting"] = messages_waiting.load();
+      result["messages_handling"] = messages_handling.load();
+      result["max_messages_waiting"] = max_messages_waiting.load();
+      result["messages_handled"] = messages_handled.load();
+      return result;
+    }
+
+    shared_message_ptr peer_connection::real_queued_message::get_message(peer_connection_delegate*)
     {
       if (message_send_time_field_offset != (size_t)-1)
       {
@@ -55,13 +167,21 @@ namespace graphene { namespace net
         memcpy(message_to_send.data.data() + message_send_time_field_offset,
                packed_current_time.data(), packed_current_time.size());
       }
-      return message_to_send;
+      return std::make_shared<const shared_message>(message_to_send);
     }
     size_t peer_connection::real_queued_message::get_size_in_queue()
     {
       return message_to_send.data.size();
     }
-    message peer_connection::virtual_queued_message::get_message(peer_connection_delegate* node)
+    shared_message_ptr peer_connection::shared_queued_message::get_message(peer_connection_delegate*)
+    {
+      return message_to_send;
+    }
+    size_t peer_connection::shared_queued_message::get_size_in_queue()
+    {
+      return message_to_send->buffer().size();
+    }
+    shared_message_ptr peer_connection::virtual_queued_message::get_message(peer_connection_delegate* node)
     {
       return node->get_message_for_item(item_to_send);
     }
@@ -71,8 +191,9 @@ namespace graphene { namespace net
       return sizeof(item_id);
     }
 
-    peer_connection::peer_connection(peer_connection_delegate* delegate) :
+    peer_connection::peer_connection(peer_connection_delegate* delegate, message_processing_pool_ptr message_processing_pool) :
       _node(delegate),
+      _message_processing_pool(std::move(message_processing_pool)),
       _message_connection(this),
       _total_queued_messages_size(0),
       direction(peer_connection_direction::unknown),
@@ -89,15 +210,24 @@ namespace graphene { namespace net
       transaction_fetching_inhibited_until(fc::time_point::min()),
       last_known_fork_block_number(0),
       firewall_check_state(nullptr),
-#ifndef NDEBUG
       _thread(&fc::thread::current()),
+#ifndef NDEBUG
       _send_message_queue_tasks_running(0),
 #endif
-      _currently_handling_message(false)
+      _currently_handling_message(false),
+      _messages_waiting_for_handling(0),
+      _counted_in_message_processing_pool(false)
     {
+      if (_message_processing_pool)
+      {
+        _message_connection.set_read_thread(_message_processing_pool->next_thread());
+        ++_message_processing_pool->connections;
+        _counted_in_message_processing_pool = true;
+      }
     }
 
-    peer_connection_ptr peer_connection::make_shared(peer_connection_delegate* delegate)
+    peer_connection_ptr peer_connection::make_shared(peer_connection_delegate* delegate,
+                                                     message_processing_pool_ptr message_processing_pool)
     {
       // The lifetime of peer_connection objects is managed by shared_ptrs in node.  The peer_connection
       // is responsible for notifying the node when it should be deleted, and the process of deleting it
@@ -107,7 +237,7 @@ namespace graphene { namespace net
       // current task yields.  In the (not uncommon) case where it is the task executing
       // connect_to or read_loop, this allows the task to finish before the destructor is forced
       // to cancel it.
-      return peer_connection_ptr(new peer_connection(delegate));
+      return peer_connection_ptr(new peer_connection(delegate, std::move(message_processing_pool)));
       //, [](peer_connection* peer_to_delete){ fc::async([peer_to_delete](){delete peer_to_delete;}); });
     }
 
@@ -171,6 +301,32 @@ namespace graphene { namespace net
       }
 
       _message_connection.destroy_connection(); // shut down the read loop
+
+      // the read loop may have passed a call to this thread before it was canceled.  Waiting for it here only
+      // yields this task, so the call can finish if it is already running
+      std::shared_ptr<node_thread_call> last_call;
+      {
+        std::lock_guard<std::mutex> guard(_node_thread_call_mutex);
+        last_call.swap(_node_thread_call);
+      }
+      if (last_call)
+      {
+        try
+        {
+          last_call->cancel()->wait();
+        }
+        catch ( const fc::exception& e )
+        {
+          wlog("Unexpected exception while waiting for peer_connection's call on the node's thread : ${e}", ("e", e));
+        }
+      }
+
+      // destroy() runs again from the destructor after destroy_connection()
+      if (_counted_in_message_processing_pool)
+      {
+        --_message_processing_pool->connections;
+        _counted_in_message_processing_pool = false;
+      }
     }
 
     peer_connection::~peer_connection()
@@ -266,17 +422,112 @@ namespace graphene { namespace net
     } // connect_to()
 
     void peer_connection::on_message( message_oriented_connection* originating_connection, const message& received_message )
+    {
+      if (_thread->is_current())
+      {
+        handle_message( received_message, received_message.id(), decoded_message() );
+        return;
+      }
+
+      // we're on a thread of the message processing pool: do everything which doesn't touch the node's
+      // state here, and leave only the handling of the message to the node's thread
+      message_hash_type message_hash;
+      decoded_message decoded;
+      {
+        stage_counter decoding( _message_processing_pool->messages_decoding );
+        message_hash = received_message.id();
+        if( received_message.msg_type == block_message_type )
+          decoded.block = std::make_shared<const block_message>( received_message.as<block_message>() );
+        else if( received_message.msg_type == trx_message_type )
+          decoded.trx = std::make_shared<const trx_message>( received_message.as<trx_message>() );
+      }
+
+      // the call may outlive this frame if the read loop is canceled, so it gets its own copy of the message
+      std::shared_ptr<const message> message_to_handle = std::make_shared<const message>( received_message );
+      message_processing_pool_ptr pool = _message_processing_pool;
+      std::shared_ptr<stage_counter> waiting = std::make_shared<stage_counter>( pool->messages_waiting );
+      pool->update_max_messages_waiting();
+      // a queued message counts as being handled, so the node doesn't think the connection has stalled meanwhile
+      ++_messages_waiting_for_handling;
+      BOOST_SCOPE_EXIT(this_) {
+        --this_->_messages_waiting_for_handling;
+      } BOOST_SCOPE_EXIT_END
+      call_on_node_thread( [this, pool, waiting, message_to_handle, message_hash, decoded]() {
+        waiting->leave();
+        stage_counter handling( pool->messages_handling );
+        handle_message( *message_to_handle, message_hash, decoded );
+        ++pool->messages_handled;
+      }, "handle peer message" );
+    }
+
+    void peer_connection::handle_message( const message& received_message, const message_hash_type& message_hash,
+                                          const decoded_message& decoded )
     {
       VERIFY_CORRECT_THREAD();
       _currently_handling_message = true;
       BOOST_SCOPE_EXIT(this_) {
         this_->_currently_handling_message = false;
       } BOOST_SCOPE_EXIT_END
-      _node->on_message( this, received_message );
+      _node->on_message( this, received_message, message_hash, decoded );
+    }
+
+    void peer_connection::call_on_node_thread( const std::function<void()>& call, const char* description )
+    {
+      // The call keeps the connection alive until it is done.  It takes its reference over when it runs, so the last
+      // reference is never released on the pool's thread, where the connection can't be destroyed
+      peer_connection_ptr self;
+      try
+      {
+        self = shared_from_this();
+      }
+      catch ( const std::bad_weak_ptr& )
+      {
+        FC_THROW_EXCEPTION( fc::canceled_exception, "the peer connection is being destroyed" );
+      }
+      std::shared_ptr<node_thread_call> state = std::make_shared<node_thread_call>();
+      {
+        std::lock_guard<std::mutex> guard(_node_thread_call_mutex);
+        _node_thread_call = state;
+      }
+      fc::future<void> call_done = _thread->async( [self, state, call]() mutable {
+        peer_connection_ptr connection;
+        connection.swap( self );
+        if (!state->start())
+          return;
+        // the call is finished before the reference to the connection is released, so a destructor which runs
+        // here doesn't wait for it
+        try
+        {
+          call();
+        }
+        catch ( ... )
+        {
+          state->finish();
+          throw;
+        }
+        state->finish();
+      }, description );
+      self.reset();
+
+      try
+      {
+        call_done.wait();
+      }
+      catch ( const fc::canceled_exception& )
+      {
+        // the read loop is being shut down.  A call which has already started keeps running, destroy() waits for it
+        state->cancel();
+        throw;
+      }
     }
 
     void peer_connection::on_connection_closed( message_oriented_connection* originating_connection )
     {
+      if (!_thread->is_current())
+      {
+        call_on_node_thread( [=]() { on_connection_closed( originating_connection ); }, "peer connection closed" );
+        return;
+      }
       VERIFY_CORRECT_THREAD();
       negotiation_status = connection_negotiation_status::closed;
       _node->on_connection_closed( this );
@@ -295,12 +546,12 @@ namespace graphene { namespace net
       while (!_queued_messages.empty())
       {
         _queued_messages.front()->transmission_start_time = fc::time_point::now();
-        message message_to_send = _queued_messages.front()->get_message(_node);
+        shared_message_ptr message_to_send = _queued_messages.front()->get_message(_node);
         try
         {
           //dlog("peer_connection::send_queued_messages_task() calling message_oriented_connection::send_message() "
           //     "to send message of type ${type} for peer ${endpoint}",
-          //     ("type", message_to_send.msg_type)("endpoint", get_remote_endpoint()));
+          //     ("type", message_to_send->header().msg_type)("endpoint", get_remote_endpoint()));
           _message_connection.send_message(message_to_send);
           //dlog("peer_connection::send_queued_messages_task()'s call to message_oriented_connection::send_message() completed normally for peer ${endpoint}",
           //     ("endpoint", get_remote_endpoint()));
@@ -375,7 +626,18 @@ namespace graphene { namespace net
       VERIFY_CORRECT_THREAD();
       //dlog("peer_connection::send_message() enqueueing message of type ${type} for peer ${endpoint}",
       //     ("type", message_to_send.msg_type)("endpoint", get_remote_endpoint()));
-      std::unique_ptr<queued_message> message_to_enqueue(new real_queued_message(message_to_send, message_send_time_field_offset));
+      std::unique_ptr<queued_message> message_to_enqueue;
+      if (message_send_time_field_offset != (size_t)-1)
+        message_to_enqueue.reset(new real_queued_message(message_to_send, message_send_time_field_offset));
+      else
+        message_to_enqueue.reset(new shared_queued_message(std::make_shared<const shared_message>(message_to_send)));
+      send_queueable_message(std::move(message_to_enqueue));
+    }
+
+    void peer_connection::send_message(const shared_message_ptr& message_to_send)
+    {
+      VERIFY_CORRECT_THREAD();
+      std::unique_ptr<queued_message> message_to_enqueue(new shared_queued_message(message_to_send));
       send_queueable_message(std::move(message_to_enqueue));
     }
 
@@ -460,7 +722,7 @@ namespace graphene { namespace net
     bool peer_connection::is_currently_handling_message() const
     {
       VERIFY_CORRECT_THREAD();
-      return _currently_handling_message;
+      return _currently_handling_message || _messages_waiting_for_handling > 0;
     }
 
     bool peer_connection::is_transaction_fetching_inhibited() const
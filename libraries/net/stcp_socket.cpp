@@ -38,8 +38,10 @@ namespace graphene { namespace net {
 
 stcp_socket::stcp_socket()
 //:_buf_len(0)
+   : _read_buffer_length(0),
+     _write_buffer_length(0)
 #ifndef NDEBUG
-   : _read_buffer_in_use(false),
+   , _read_buffer_in_use(false),
      _write_buffer_in_use(false)
 #endif
 {
@@ -80,6 +82,25 @@ void stcp_socket::bind( const fc::ip::endpoint& local_endpoint )
   _sock.bind(local_endpoint);
 }
 
+/**
+ *  Makes sure the buffer can hold len bytes, up to max_buffer_length, and returns how many bytes it can hold.  The
+ *  buffers grow to the largest frame which has been read or written, so that a block sized message goes through the
+ *  cipher and the socket at once instead of in small chunks.  Larger frames are handled in max_buffer_length chunks,
+ *  so a connection never keeps more than that per buffer.  They are replaced rather than resized, as the socket may
+ *  still hold a reference to the old one.
+ */
+static size_t reserve_buffer( std::shared_ptr<char>& buffer, size_t& buffer_length, size_t len )
+{
+  const size_t min_buffer_length = 4096;
+  const size_t max_buffer_length = 64 * 1024;
+  len = std::min( max_buffer_length, len );
+  if( buffer && buffer_length >= len )
+    return len;
+  buffer_length = std::max( min_buffer_length, len );
+  buffer.reset(new char[buffer_length], [](char* p){ delete[] p; });
+  return len;
+}
+
 /**
  *   This method must read at least 16 bytes at a time from
  *   the underlying TCP socket so that it can decrypt them. It
@@ -100,11 +121,7 @@ size_t stcp_socket::readsome( char* buffer, size_t len )
     } buffer_in_use_checker(_read_buffer_in_use);
 #endif
 
-    const size_t read_buffer_length = 4096;
-    if (!_read_buffer)
-      _read_buffer.reset(new char[read_buffer_length], [](char* p){ delete[] p; });
-
-    len = std::min<size_t>(read_buffer_length, len);
+    len = reserve_buffer( _read_buffer, _read_buffer_length, len );
 
     size_t s = _sock.readsome( _read_buffer, len, 0 );
     if( s % 16 ) 
@@ -141,11 +158,7 @@ size_t stcp_socket::writesome( const char* buffer, size_t len )
     } buffer_in_use_checker(_write_buffer_in_use);
 #endif
 
-    const std::size_t write_buffer_length = 4096;
-    if (!_write_buffer)
-      _write_buffer.reset(new char[write_buffer_length], [](char* p){ delete[] p; });
-    len = std::min<size_t>(write_buffer_length, len);
-    memset(_write_buffer.get(), 0, len); // just in case aes.encode screws up
+    len = reserve_buffer( _write_buffer, _write_buffer_length, len );
     /**
      * every sizeof(crypt_buf) bytes the aes channel
      * has an error and doesn't decrypt properly...  disable
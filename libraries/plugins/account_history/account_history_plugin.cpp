@@ -37,6 +37,8 @@
 #include <fc/smart_ref_impl.hpp>
 #include <fc/thread/thread.hpp>
 
+#include <boost/filesystem/path.hpp>
+
 namespace graphene { namespace account_history {
 
 namespace detail
@@ -57,6 +59,9 @@ class account_history_plugin_impl
        */
       void update_account_histories( const signed_block& b );
 
+      /** moves the history of irreversible blocks which have left the memory window into the store */
+      void archive_history();
+
       graphene::chain::database& database()
       {
          return _self.database();
@@ -64,6 +69,10 @@ class account_history_plugin_impl
 
       account_history_plugin& _self;
       flat_set<account_id_type> _tracked_accounts;
+
+      history_store _store;
+      uint32_t      _memory_window = 0;
+      bool          _store_checked = false;
 };
 
 account_history_plugin_impl::~account_history_plugin_impl()
@@ -150,6 +159,7 @@ void account_history_plugin_impl::update_account_histories( const signed_block&
                 obj.account = account_id;
                 obj.sequence = stats_obj.total_ops+1;
                 obj.next = stats_obj.most_recent_op;
+                obj.op_type = op.op.which();
             });
             db.modify( stats_obj, [&]( account_statistics_object& obj ){
                 obj.most_recent_op = ath.id;
@@ -167,15 +177,58 @@ void account_history_plugin_impl::update_account_histories( const signed_block&
                const auto& stats_obj = account_id(db).statistics(db);
                const auto& ath = db.create<account_transaction_history_object>( [&]( account_transaction_history_object& obj ){
                    obj.operation_id = oho_valid_pair.first.id;
+                   obj.account = account_id;
+                   obj.sequence = stats_obj.total_ops+1;
                    obj.next = stats_obj.most_recent_op;
+                   obj.op_type = op.op.which();
                });
                db.modify( stats_obj, [&]( account_statistics_object& obj ){
                    obj.most_recent_op = ath.id;
+                   obj.total_ops = ath.sequence;
                });
             }
          }
       }
    }
+
+   if( _store.is_open() )
+      archive_history();
+}
+
+void account_history_plugin_impl::archive_history()
+{
+   graphene::chain::database& db = database();
+   const auto& dgpo = db.get_dynamic_global_properties();
+   if( dgpo.head_block_number <= _memory_window )
+      return;
+   // Only irreversible history leaves memory, so the store never has to be rolled back:
+   const uint32_t cutoff = std::min( dgpo.last_irreversible_block_num, dgpo.head_block_number - _memory_window );
+
+   const auto& op_idx = db.get_index_type<operation_history_index>().indices().get<by_id>();
+   if( op_idx.empty() || op_idx.begin()->block_num > cutoff )
+      return;
+
+   // If the store holds operations which the database is about to recreate, e.g. while replaying, drop them:
+   if( !_store_checked )
+   {
+      if( op_idx.begin()->id.instance() < _store.next_operation() )
+         _store.truncate( op_idx.begin()->id );
+      _store_checked = true;
+   }
+
+   // Account history entries go first, while their operations are still in memory:
+   const auto& entry_idx = db.get_index_type<account_transaction_history_index>().indices().get<by_id>();
+   while( !entry_idx.empty() && entry_idx.begin()->operation_id(db).block_num <= cutoff )
+   {
+      _store.append( *entry_idx.begin() );
+      db.remove( *entry_idx.begin() );
+   }
+
+   while( !op_idx.empty() && op_idx.begin()->block_num <= cutoff )
+   {
+      _store.append( *op_idx.begin() );
+      db.remove( *op_idx.begin() );
+   }
 }
 } // end namespace detail
 
@@ -205,6 +258,10 @@ void account_history_plugin::plugin_set_program_options(
 {
    cli.add_options()
          ("track-account", boost::program_options::value<std::vector<std::string>>()->composing()->multitoken(), "Account ID to track history for (may specify multiple times)")
+         ("history-memory-window", boost::program_options::value<uint32_t>(),
+          "Keep the operation history of only this many recent blocks in memory, and move older history to disk")
+         ("history-store-dir", boost::program_options::value<boost::filesystem::path>(),
+          "Directory of the history moved to disk, defaults to <data-dir>/history")
          ;
    cfg.add(cli);
 }
@@ -216,15 +273,40 @@ void account_history_plugin::plugin_initialize(const boost::program_options::var
    database().add_index< primary_index< account_transaction_history_index > >();
 
    LOAD_VALUE_SET(options, "tracked-accounts", my->_tracked_accounts, graphene::chain::account_id_type);
+
+   if( options.count("history-memory-window") )
+   {
+      my->_memory_window = options["history-memory-window"].as<uint32_t>();
+      if( options.count("history-store-dir") )
+         my->_store.open( options["history-store-dir"].as<boost::filesystem::path>() );
+      else
+         my->_store.open( app().data_dir() / "history" );
+      // History removed from the object database must be on disk before the object database is:
+      database().flushing.connect( [&]() {
+         if( my->_store.is_open() )
+            my->_store.flush();
+      } );
+   }
 }
 
 void account_history_plugin::plugin_startup()
 {
 }
 
+void account_history_plugin::plugin_shutdown()
+{
+   if( my->_store.is_open() )
+      my->_store.close();
+}
+
 flat_set<account_id_type> account_history_plugin::tracked_accounts() const
 {
    return my->_tracked_accounts;
 }
 
+const history_store* account_history_plugin::store() const
+{
+   return my->_store.is_open() ? &my->_store : nullptr;
+}
+
 } }
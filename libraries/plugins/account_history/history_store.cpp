@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <graphene/account_history/history_store.hpp>
+
+#include <fc/io/raw.hpp>
+#include <fc/smart_ref_impl.hpp>
+
+#include <limits>
+
+namespace graphene { namespace account_history {
+
+namespace detail {
+
+static const uint32_t checkpoint_stride = 100;
+static const uint64_t no_record = std::numeric_limits<uint64_t>::max();
+
+struct operation_index_entry
+{
+   uint64_t pos = 0;
+   uint32_t size = 0;   ///< 0 if there is no operation with this instance
+};
+
+struct account_record
+{
+   uint64_t account = 0;
+   uint64_t entry = 0;                ///< instance of the account_transaction_history_object
+   uint64_t operation = 0;
+   uint64_t next = 0;
+   uint64_t previous = no_record;     ///< the record of the previous entry of the same account
+   uint32_t sequence = 0;
+   uint32_t op_type = 0;
+};
+
+static void open_file( std::fstream& f, const fc::path& p )
+{
+   f.exceptions( std::ios_base::failbit | std::ios_base::badbit );
+   auto mode = std::fstream::binary | std::fstream::in | std::fstream::out;
+   if( !fc::exists( p ) )
+      mode |= std::fstream::trunc;
+   f.open( p.generic_string().c_str(), mode );
+}
+
+static uint64_t file_size( std::fstream& f )
+{
+   f.seekg( 0, f.end );
+   return f.tellg();
+}
+
+} // graphene::account_history::detail
+
+void history_store::open( const fc::path& dir )
+{ try {
+   std::lock_guard<std::mutex> guard( _mutex );
+   fc::create_directories( dir );
+   _dir = dir;
+   open_files();
+   load_accounts();
+} FC_CAPTURE_AND_RETHROW( (dir) ) }
+
+void history_store::open_files()
+{
+   detail::open_file( _operations, _dir / "operations" );
+   detail::open_file( _operations_index, _dir / "operations.index" );
+   detail::open_file( _accounts, _dir / "accounts" );
+
+   _next_operation = detail::file_size( _operations_index ) / sizeof( detail::operation_index_entry );
+   _account_records = detail::file_size( _accounts ) / sizeof( detail::account_record );
+}
+
+bool history_store::is_open()const
+{
+   return _operations.is_open();
+}
+
+void history_store::flush()
+{
+   std::lock_guard<std::mutex> guard( _mutex );
+   _operations.flush();
+   _operations_index.flush();
+   _accounts.flush();
+}
+
+void history_store::close()
+{
+   std::lock_guard<std::mutex> guard( _mutex );
+   _operations.close();
+   _operations_index.close();
+   _accounts.close();
+   _positions.clear();
+}
+
+void history_store::append( const operation_history_object& op )
+{
+   std::lock_guard<std::mutex> guard( _mutex );
+   const uint64_t instance = op.id.instance();
+   if( instance < _next_operation )
+      return;
+
+   auto data = fc::raw::pack( op );
+   detail::operation_index_entry e;
+   _operations.seekp( 0, _operations.end );
+   e.pos  = _operations.tellp();
+   e.size = data.size();
+   _operations.write( data.data(), data.size() );
+   // Instances of operations which were never stored are left as empty entries:
+   _operations_index.seekp( sizeof( e ) * instance );
+   _operations_index.write( (char*)&e, sizeof( e ) );
+   _next_operation = instance + 1;
+}
+
+void history_store::append( const account_transaction_history_object& entry )
+{
+   std::lock_guard<std::mutex> guard( _mutex );
+   const uint64_t account = entry.account.instance.value;
+   auto itr = _positions.find( account );
+   if( entry.sequence == 0 || ( itr != _positions.end() && entry.sequence <= itr->second.last_sequence ) )
+      return;
+
+   detail::account_record r;
+   r.account   = account;
+   r.entry     = entry.id.instance();
+   r.operation = entry.operation_id.instance.value;
+   r.next      = entry.next.instance.value;
+   r.sequence  = entry.sequence;
+   r.op_type   = entry.op_type;
+   // A gap in the sequence starts a new chain, the entries before it cannot be found anymore:
+   if( itr != _positions.end() && entry.sequence == itr->second.last_sequence + 1 )
+      r.previous = itr->second.last_record;
+
+   _accounts.seekp( sizeof( r ) * _account_records );
+   _accounts.write( (char*)&r, sizeof( r ) );
+   index_account_record( _account_records++, r );
+}
+
+void history_store::truncate( operation_history_id_type op )
+{ try {
+   std::lock_guard<std::mutex> guard( _mutex );
+   const uint64_t instance = op.instance.value;
+
+   // The data of the first stored operation from the instance onwards is where the operations file ends:
+   optional<uint64_t> operations_end;
+   for( uint64_t i = instance; i < _next_operation && !operations_end.valid(); ++i )
+   {
+      detail::operation_index_entry e;
+      _operations_index.seekg( sizeof( e ) * i );
+      _operations_index.read( (char*)&e, sizeof( e ) );
+      if( e.size > 0 )
+         operations_end = e.pos;
+   }
+
+   // Account records refer to operations in increasing order:
+   uint64_t low = 0, high = _account_records;
+   while( low < high )
+   {
+      const uint64_t mid = low + ( high - low ) / 2;
+      if( read_account_record( mid ).operation < instance )
+         low = mid + 1;
+      else
+         high = mid;
+   }
+
+   _operations.close();
+   _operations_index.close();
+   _accounts.close();
+   if( operations_end.valid() )
+      fc::resize_file( _dir / "operations", *operations_end );
+   if( instance < _next_operation )
+      fc::resize_file( _dir / "operations.index", sizeof( detail::operation_index_entry ) * instance );
+   fc::resize_file( _dir / "accounts", sizeof( detail::account_record ) * low );
+
+   open_files();
+   load_accounts();
+} FC_CAPTURE_AND_RETHROW( (op) ) }
+
+optional<operation_history_object> history_store::get_operation( operation_history_id_type op )const
+{
+   std::lock_guard<std::mutex> guard( _mutex );
+   const uint64_t instance = op.instance.value;
+   if( instance >= _next_operation )
+      return {};
+
+   detail::operation_index_entry e;
+   _operations_index.seekg( sizeof( e ) * instance );
+   _operations_index.read( (char*)&e, sizeof( e ) );
+   if( e.size == 0 )
+      return {};
+
+   vector<char> data( e.size );
+   _operations.seekg( e.pos );
+   _operations.read( data.data(), e.size );
+   return fc::raw::unpack<operation_history_object>( data );
+}
+
+uint32_t history_store::last_sequence( account_id_type account )const
+{
+   std::lock_guard<std::mutex> guard( _mutex );
+   auto itr = _positions.find( account.instance.value );
+   return itr != _positions.end() ? itr->second.last_sequence : 0;
+}
+
+vector<account_transaction_history_object> history_store::get_account_history( account_id_type account,
+                                                                               uint32_t sequence,
+                                                                               uint32_t count )const
+{
+   std::lock_guard<std::mutex> guard( _mutex );
+   vector<account_transaction_history_object> result;
+   auto itr = _positions.find( account.instance.value );
+   if( itr == _positions.end() || count == 0 || sequence < itr->second.first_sequence )
+      return result;
+   const account_position& pos = itr->second;
+   sequence = std::min( sequence, pos.last_sequence );
+
+   // Start from the nearest checkpoint at or after the sequence, and walk back to it:
+   const uint64_t checkpoint = ( sequence - pos.first_sequence + detail::checkpoint_stride - 1 ) / detail::checkpoint_stride;
+   auto r = read_account_record( checkpoint < pos.checkpoints.size() ? pos.checkpoints[checkpoint] : pos.last_record );
+   while( r.sequence > sequence )
+      r = read_account_record( r.previous );
+
+   result.reserve( count );
+   while( true )
+   {
+      account_transaction_history_object entry;
+      entry.id           = account_transaction_history_id_type( r.entry );
+      entry.account      = account_id_type( r.account );
+      entry.operation_id = operation_history_id_type( r.operation );
+      entry.sequence     = r.sequence;
+      entry.next         = account_transaction_history_id_type( r.next );
+      entry.op_type      = r.op_type;
+      result.push_back( std::move( entry ) );
+
+      if( result.size() >= count || r.previous == detail::no_record )
+         break;
+      r = read_account_record( r.previous );
+   }
+   return result;
+}
+
+detail::account_record history_store::read_account_record( uint64_t record_num )const
+{
+   detail::account_record r;
+   _accounts.seekg( sizeof( r ) * record_num );
+   _accounts.read( (char*)&r, sizeof( r ) );
+   return r;
+}
+
+void history_store::load_accounts()
+{
+   _positions.clear();
+   _accounts.seekg( 0 );
+
+   const uint64_t batch = 4096;
+   vector<detail::account_record> records;
+   for( uint64_t record_num = 0; record_num < _account_records; )
+   {
+      records.resize( std::min( batch, _account_records - record_num ) );
+      _accounts.read( (char*)records.data(), sizeof( detail::account_record ) * records.size() );
+      for( const auto& r : records )
+         index_account_record( record_num++, r );
+   }
+}
+
+void history_store::index_account_record( uint64_t record_num, const detail::account_record& r )
+{
+   auto& pos = _positions[r.account];
+   if( r.previous == detail::no_record )
+   {
+      pos = account_position();
+      pos.first_sequence = r.sequence;
+   }
+
+   pos.last_sequence = r.sequence;
+   pos.last_record = record_num;
+   if( ( r.sequence - pos.first_sequence ) % detail::checkpoint_stride == 0 )
+      pos.checkpoints.push_back( record_num );
+}
+
+} } // graphene::account_history
@@ -23,6 +23,7 @@
  */
 #pragma once
 
+#include <graphene/account_history/history_store.hpp>
 #include <graphene/app/plugin.hpp>
 #include <graphene/chain/database.hpp>
 
@@ -53,7 +54,9 @@ namespace graphene { namespace account_history {
 enum account_history_object_type
 {
    key_account_object_type = 0,
-   bucket_object_type = 1 ///< used in market_history_plugin
+   bucket_object_type = 1, ///< used in market_history_plugin
+   market_ticker_object_type = 3, ///< used in market_history_plugin
+   market_ticker_meta_object_type = 4 ///< used in market_history_plugin
 };
 
 
@@ -74,8 +77,11 @@ class account_history_plugin : public graphene::app::plugin
          boost::program_options::options_description& cfg) override;
       virtual void plugin_initialize(const boost::program_options::variables_map& options) override;
       virtual void plugin_startup() override;
+      virtual void plugin_shutdown() override;
 
       flat_set<account_id_type> tracked_accounts()const;
+      /** @return the store of the history which has left memory, nullptr if all history is kept in memory */
+      const history_store* store()const;
 
       friend class detail::account_history_plugin_impl;
       std::unique_ptr<detail::account_history_plugin_impl> my;
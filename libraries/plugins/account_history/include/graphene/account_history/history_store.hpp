@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <graphene/chain/operation_history_object.hpp>
+
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+
+namespace graphene { namespace account_history {
+   using namespace chain;
+
+   namespace detail { struct account_record; }
+
+   /**
+    * @brief Append-only on-disk storage of operation history which has left the in-memory window.
+    *
+    * Operations are packed one after another into the "operations" file, and located through the fixed-size
+    * entries of "operations.index", one per operation instance. The entries of account histories are appended to
+    * "accounts" as fixed-size records which point back to the previous record of the same account, so the history
+    * of an account can be read from its most recent archived entry backwards.
+    *
+    * Only the position of the last record of each account, and of every hundredth one, is kept in memory. These
+    * are rebuilt from the "accounts" file when the store is opened.
+    */
+   class history_store
+   {
+      public:
+         void open( const fc::path& dir );
+         bool is_open()const;
+         void flush();
+         void close();
+
+         /** @return the instance of the operation which is expected to be appended next */
+         uint64_t next_operation()const { return _next_operation; }
+
+         /**
+          * Appends an operation. Operations must be appended in the order of their ids, and an operation whose id is
+          * lower than next_operation() is ignored, as it has been stored already.
+          */
+         void append( const operation_history_object& op );
+         /**
+          * Appends an entry of the history of an account. Entries of an account must be appended in the order of
+          * their sequence numbers, and an entry which is not newer than the last one stored is ignored.
+          */
+         void append( const account_transaction_history_object& entry );
+
+         /** Removes all operations from op onwards, and the account history entries which refer to them */
+         void truncate( operation_history_id_type op );
+
+         optional<operation_history_object> get_operation( operation_history_id_type op )const;
+
+         /** @return the last sequence number stored for an account, 0 if there is none */
+         uint32_t last_sequence( account_id_type account )const;
+
+         /**
+          * @return at most count entries of the history of an account, starting from the one with the given sequence
+          * number (or the most recent stored one, if it is lower) and going back in time
+          */
+         vector<account_transaction_history_object> get_account_history( account_id_type account,
+                                                                         uint32_t sequence,
+                                                                         uint32_t count )const;
+
+      private:
+         struct account_position
+         {
+            uint32_t         first_sequence = 0;
+            uint32_t         last_sequence = 0;
+            uint64_t         last_record = 0;
+            vector<uint64_t> checkpoints;   ///< records of every hundredth sequence, from first_sequence
+         };
+
+         void open_files();
+         void load_accounts();
+         void index_account_record( uint64_t record_num, const detail::account_record& r );
+         detail::account_record read_account_record( uint64_t record_num )const;
+
+         fc::path _dir;
+         mutable std::fstream _operations;
+         mutable std::fstream _operations_index;
+         mutable std::fstream _accounts;
+
+         uint64_t _next_operation = 0;
+         uint64_t _account_records = 0;
+         std::unordered_map<uint64_t, account_position> _positions;
+
+         mutable std::mutex _mutex;
+   };
+
+} } //graphene::account_history
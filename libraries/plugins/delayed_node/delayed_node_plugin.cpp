@@ -31,6 +31,9 @@
 #include <fc/rpc/websocket_api.hpp>
 #include <fc/api.hpp>
 #include <fc/smart_ref_impl.hpp>
+#include <fc/thread/thread.hpp>
+
+#include <deque>
 
 
 namespace graphene { namespace delayed_node {
@@ -45,6 +48,7 @@ struct delayed_node_plugin_impl {
    boost::signals2::scoped_connection client_connection_closed;
    graphene::chain::block_id_type last_received_remote_head;
    graphene::chain::block_id_type last_processed_remote_head;
+   uint32_t sync_window = 100;
 };
 }
 
@@ -59,6 +63,8 @@ void delayed_node_plugin::plugin_set_program_options(bpo::options_description& c
 {
    cli.add_options()
          ("trusted-node", boost::program_options::value<std::string>()->required(), "RPC endpoint of a trusted validating node (required)")
+         ("delayed-node-sync-window", boost::program_options::value<uint32_t>()->default_value(100),
+          "Number of blocks requested ahead from the trusted node while catching up, 0 to fetch one block at a time")
          ;
    cfg.add(cli);
 }
@@ -75,6 +81,8 @@ void delayed_node_plugin::connect()
 void delayed_node_plugin::plugin_initialize(const boost::program_options::variables_map& options)
 {
    my->remote_endpoint = "ws://" + options.at("trusted-node").as<std::string>();
+   if( options.count("delayed-node-sync-window") )
+      my->sync_window = options.at("delayed-node-sync-window").as<uint32_t>();
 }
 
 void delayed_node_plugin::sync_with_trusted_node()
@@ -98,6 +106,10 @@ void delayed_node_plugin::sync_with_trusted_node()
          break;
       }
       pass_count++;
+      // get_blocks never returns the head block of the trusted node, which may be its last irreversible one, so the
+      // pipeline stops one block short and the rest is fetched one at a time:
+      if( my->sync_window > 0 && remote_dpo.last_irreversible_block_num > db.head_block_num() + 1 )
+         sync_pipelined( remote_dpo.last_irreversible_block_num - 1, synced_blocks );
       while( remote_dpo.last_irreversible_block_num > db.head_block_num() )
       {
          fc::optional<graphene::chain::signed_block> block = my->database_api->get_block( db.head_block_num()+1 );
@@ -109,6 +121,40 @@ void delayed_node_plugin::sync_with_trusted_node()
    }
 }
 
+void delayed_node_plugin::sync_pipelined( uint32_t last_block_num, uint32_t& synced_blocks )
+{
+   auto& db = database();
+   const uint32_t batch_size = std::min( my->sync_window, 100u ); // get_blocks limit
+   std::deque< fc::future< vector<graphene::chain::signed_block_with_num> > > requests;
+   uint32_t next_request = db.head_block_num() + 1;
+
+   while( db.head_block_num() < last_block_num )
+   {
+      // Keep up to sync_window blocks requested ahead, so the next batches are in transit while this one is applied
+      while( next_request <= last_block_num && next_request <= db.head_block_num() + my->sync_window )
+      {
+         const uint32_t start = next_request;
+         const uint32_t count = std::min( batch_size, last_block_num - start + 1 );
+         auto api = my->database_api;
+         requests.push_back( fc::async( [api, start, count]() { return api->get_blocks( start, count ); } ) );
+         next_request += count;
+      }
+      // Let the new requests be sent before blocking on the oldest one
+      fc::yield();
+
+      const auto blocks = requests.front().wait();
+      requests.pop_front();
+      FC_ASSERT( !blocks.empty(), "Trusted node claims it has blocks it doesn't actually have." );
+      for( const auto& block : blocks )
+      {
+         FC_ASSERT( block.num == db.head_block_num() + 1, "Trusted node returned block #${n} out of order", ("n", block.num) );
+         ilog("Pushing block #${n}", ("n", block.num));
+         db.push_block( block.block );
+         synced_blocks++;
+      }
+   }
+}
+
 void delayed_node_plugin::mainloop()
 {
    while( true )
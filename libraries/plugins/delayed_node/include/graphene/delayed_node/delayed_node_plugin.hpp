@@ -46,6 +46,7 @@ protected:
    void connection_failed();
    void connect();
    void sync_with_trusted_node();
+   void sync_pipelined( uint32_t last_block_num, uint32_t& synced_blocks );
 };
 
 } } //graphene::account_history
@@ -25,6 +25,7 @@
 
 #include <graphene/app/plugin.hpp>
 #include <graphene/chain/database.hpp>
+#include <graphene/db/simple_index.hpp>
 
 #include <fc/thread/future.hpp>
 
@@ -158,8 +159,60 @@ typedef multi_index_container<
 > order_history_multi_index_type;
 
 
+/**
+ *  Rolling statistics of a market over the last 24 hours (of block time), updated as fills are recorded in the order
+ *  history and as they leave the window. Prices are kept with the lower asset id as the base.
+ */
+struct market_ticker_object : public abstract_object<market_ticker_object>
+{
+   static const uint8_t space_id = ACCOUNT_HISTORY_SPACE_ID;
+   static const uint8_t type_id  = 3; // market_history_plugin type, referenced from account_history_plugin.hpp
+
+   asset_id_type       base;
+   asset_id_type       quote;
+   price               latest_price;
+   /** price of the most recent fill which has left the window, if any */
+   optional<price>     previous_price;
+   /** highest and lowest price of the maker fills in the window, only valid when trade_count is not zero */
+   price               high;
+   price               low;
+   /** volumes of the maker fills in the window, in base and quote asset */
+   share_type          base_volume;
+   share_type          quote_volume;
+   uint32_t            trade_count = 0;
+};
+
+/**
+ *  The single object tracking which fills of the order history are still inside the 24 hour window.
+ */
+struct market_ticker_meta_object : public abstract_object<market_ticker_meta_object>
+{
+   static const uint8_t space_id = ACCOUNT_HISTORY_SPACE_ID;
+   static const uint8_t type_id  = 4; // market_history_plugin type, referenced from account_history_plugin.hpp
+
+   /** id of the oldest order history object which may still be in the window */
+   object_id_type      window_start;
+};
+
+struct by_market;
+typedef multi_index_container<
+   market_ticker_object,
+   indexed_by<
+      ordered_unique< tag<by_id>, member< object, object_id_type, &object::id > >,
+      ordered_unique< tag<by_market>,
+         composite_key<
+            market_ticker_object,
+            member< market_ticker_object, asset_id_type, &market_ticker_object::base >,
+            member< market_ticker_object, asset_id_type, &market_ticker_object::quote >
+         >
+      >
+   >
+> market_ticker_multi_index_type;
+
 typedef generic_index<bucket_object, bucket_object_multi_index_type> bucket_index;
 typedef generic_index<order_history_object, order_history_multi_index_type> history_index;
+typedef generic_index<market_ticker_object, market_ticker_multi_index_type> market_ticker_index;
+typedef simple_index<market_ticker_meta_object> market_ticker_meta_index;
 
 
 namespace detail
@@ -208,4 +261,9 @@ FC_REFLECT_DERIVED( graphene::market_history::bucket_object, (graphene::db::obje
                     (open_base)(open_quote)
                     (close_base)(close_quote)
                     (base_volume)(quote_volume) )
-
+FC_REFLECT_DERIVED( graphene::market_history::market_ticker_object, (graphene::db::object),
+                    (base)(quote)
+                    (latest_price)(previous_price)
+                    (high)(low)
+                    (base_volume)(quote_volume)(trade_count) )
+FC_REFLECT_DERIVED( graphene::market_history::market_ticker_meta_object, (graphene::db::object), (window_start) )
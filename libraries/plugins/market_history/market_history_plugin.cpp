@@ -53,6 +53,9 @@ class market_history_plugin_impl
        */
       void update_market_histories( const signed_block& b );
 
+      /** removes the fills which are older than 24 hours at time now from the market tickers */
+      void update_market_tickers( fc::time_point_sec now );
+
       graphene::chain::database& database()
       {
          return _self.database();
@@ -109,16 +112,67 @@ struct operation_process_fill_order
          ho.op = o;
       });
 
-      // To remove old filled order data
+      // To update the rolling 24 hour statistics of the market
+      {
+         price ticker_price = o.fill_price;
+         if( ticker_price.base.asset_id > ticker_price.quote.asset_id )
+            ticker_price = ~ticker_price;
+         const asset& base_amount = ( o.pays.asset_id == hkey.base ? o.pays : o.receives );
+         const asset& quote_amount = ( o.pays.asset_id == hkey.base ? o.receives : o.pays );
+
+         const auto& ticker_idx = db.get_index_type<market_ticker_index>().indices().get<by_market>();
+         auto ticker_itr = ticker_idx.find( std::make_tuple( hkey.base, hkey.quote ) );
+         const market_ticker_object* ticker = nullptr;
+         if( ticker_itr == ticker_idx.end() )
+            ticker = &db.create<market_ticker_object>( [&]( market_ticker_object& t ) {
+               t.base = hkey.base;
+               t.quote = hkey.quote;
+            });
+         else
+            ticker = &*ticker_itr;
+
+         db.modify( *ticker, [&]( market_ticker_object& t ) {
+            t.latest_price = ticker_price;
+            if( !o.is_maker )
+               return;
+            if( t.trade_count == 0 )
+            {
+               t.high = ticker_price;
+               t.low = ticker_price;
+            }
+            else
+            {
+               if( t.high < ticker_price )
+                  t.high = ticker_price;
+               if( ticker_price < t.low )
+                  t.low = ticker_price;
+            }
+            t.base_volume += base_amount.amount;
+            t.quote_volume += quote_amount.amount;
+            ++t.trade_count;
+         });
+      }
+
+      // To remove old filled order data. The fills which are still in the window of the market tickers are kept,
+      // else they would never be subtracted from the ticker, see update_market_tickers.
+      const auto& meta_idx = db.get_index_type<market_ticker_meta_index>();
+      const auto& his_id_idx = db.get_index_type<history_index>().indices().get<by_id>();
+      auto last_expired_itr = ( meta_idx.begin() == meta_idx.end() ? his_id_idx.begin()
+                                                                    : his_id_idx.lower_bound( meta_idx.begin()->window_start ) );
       const auto max_records = _plugin.max_order_his_records_per_market();
       hkey.sequence += max_records;
       itr = history_idx.lower_bound( hkey );
-      if( itr != history_idx.end() && itr->key.base == hkey.base && itr->key.quote == hkey.quote )
+      if( last_expired_itr != his_id_idx.begin()
+          && itr != history_idx.end() && itr->key.base == hkey.base && itr->key.quote == hkey.quote )
       {
+         // Fill objects are created in time order, so every fill up to the time of the last expired one has expired
+         const fc::time_point_sec expired_time = (--last_expired_itr)->time;
          const auto max_seconds = _plugin.max_order_his_seconds_per_market();
          fc::time_point_sec min_time;
          if( min_time + max_seconds < _now )
             min_time = _now - max_seconds;
+         if( expired_time < min_time )
+            min_time = expired_time;
          auto time_itr = his_time_idx.lower_bound( std::make_tuple( hkey.base, hkey.quote, min_time ) );
          if( time_itr != his_time_idx.end() && time_itr->key.base == hkey.base && time_itr->key.quote == hkey.quote )
          {
@@ -266,6 +320,94 @@ void market_history_plugin_impl::update_market_histories( const signed_block& b
          } FC_CAPTURE_AND_LOG( (o_op) )
       }
    }
+   update_market_tickers( b.timestamp );
+}
+
+void market_history_plugin_impl::update_market_tickers( fc::time_point_sec now )
+{
+   graphene::chain::database& db = database();
+   const auto& meta_idx = db.get_index_type<market_ticker_meta_index>();
+   if( meta_idx.begin() == meta_idx.end() )
+      db.create<market_ticker_meta_object>( []( market_ticker_meta_object& ){} );
+   const market_ticker_meta_object& meta = *meta_idx.begin();
+
+   if( now.sec_since_epoch() <= 86400 )
+      return;
+   const fc::time_point_sec cutoff = now - 86400;
+
+   const auto& his_id_idx = db.get_index_type<history_index>().indices().get<by_id>();
+   const auto& his_time_idx = db.get_index_type<history_index>().indices().get<by_market_time>();
+   const auto& ticker_idx = db.get_index_type<market_ticker_index>().indices().get<by_market>();
+
+   // Order history objects are created in time order, so the expired ones are a prefix of the id index
+   flat_set<const market_ticker_object*> stale_extremes;
+   optional<object_id_type> last_expired;
+   for( auto itr = his_id_idx.lower_bound( meta.window_start );
+        itr != his_id_idx.end() && itr->time <= cutoff; ++itr )
+   {
+      const order_history_object& ho = *itr;
+      last_expired = ho.id;
+      auto ticker_itr = ticker_idx.find( std::make_tuple( ho.key.base, ho.key.quote ) );
+      if( ticker_itr == ticker_idx.end() )
+         continue;
+
+      price ticker_price = ho.op.fill_price;
+      if( ticker_price.base.asset_id > ticker_price.quote.asset_id )
+         ticker_price = ~ticker_price;
+      const asset& base_amount = ( ho.op.pays.asset_id == ho.key.base ? ho.op.pays : ho.op.receives );
+      const asset& quote_amount = ( ho.op.pays.asset_id == ho.key.base ? ho.op.receives : ho.op.pays );
+
+      db.modify( *ticker_itr, [&]( market_ticker_object& t ) {
+         t.previous_price = ticker_price;
+         if( !ho.op.is_maker || t.trade_count == 0 )
+            return;
+         t.base_volume -= base_amount.amount;
+         t.quote_volume -= quote_amount.amount;
+         --t.trade_count;
+         if( t.trade_count == 0 )
+         {
+            t.base_volume = 0;
+            t.quote_volume = 0;
+         }
+      });
+
+      if( ho.op.is_maker && ticker_itr->trade_count > 0
+          && ( ticker_price == ticker_itr->high || ticker_price == ticker_itr->low ) )
+         stale_extremes.insert( &*ticker_itr );
+   }
+
+   if( !last_expired.valid() )
+      return;
+   db.modify( meta, [&]( market_ticker_meta_object& m ) {
+      m.window_start = *last_expired + 1;
+   });
+
+   // The high or low price has left the window, recompute them from the fills which are still in it
+   for( const market_ticker_object* ticker : stale_extremes )
+   {
+      optional<price> high;
+      optional<price> low;
+      for( auto itr = his_time_idx.lower_bound( std::make_tuple( ticker->base, ticker->quote ) );
+           itr != his_time_idx.end() && itr->key.base == ticker->base && itr->key.quote == ticker->quote
+           && itr->time > cutoff; ++itr )
+      {
+         if( !itr->op.is_maker )
+            continue;
+         price ticker_price = itr->op.fill_price;
+         if( ticker_price.base.asset_id > ticker_price.quote.asset_id )
+            ticker_price = ~ticker_price;
+         if( !high.valid() || *high < ticker_price )
+            high = ticker_price;
+         if( !low.valid() || ticker_price < *low )
+            low = ticker_price;
+      }
+      if( !high.valid() )
+         continue;
+      db.modify( *ticker, [&]( market_ticker_object& t ) {
+         t.high = *high;
+         t.low = *low;
+      });
+   }
 }
 
 } // end namespace detail
@@ -312,6 +454,8 @@ void market_history_plugin::plugin_initialize(const boost::program_options::vari
    database().applied_block.connect( [&]( const signed_block& b){ my->update_market_histories(b); } );
    database().add_index< primary_index< bucket_index  > >();
    database().add_index< primary_index< history_index  > >();
+   database().add_index< primary_index< market_ticker_index  > >();
+   database().add_index< primary_index< market_ticker_meta_index  > >();
 
    if( options.count( "bucket-size" ) )
    {
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/net/stcp_socket.hpp>
+
+#include <fc/network/tcp_socket.hpp>
+#include <fc/thread/thread.hpp>
+#include <fc/log/logger.hpp>
+
+#include <boost/test/auto_unit_test.hpp>
+
+using namespace graphene::net;
+
+BOOST_AUTO_TEST_CASE( stcp_socket_throughput_bench )
+{
+   try {
+#ifdef NDEBUG
+      const int messages_to_send = 20000;
+#else
+      const int messages_to_send = 2000;
+#endif
+      // roughly the size of a full block, padded like message_oriented_connection does
+      const size_t message_size = 64 * 1024;
+
+      fc::tcp_server server;
+      server.listen( fc::ip::endpoint( fc::ip::address( "127.0.0.1" ), 0 ) );
+
+      stcp_socket receiver;
+      fc::future<void> accepted = fc::async( [&]{
+         server.accept( receiver.get_socket() );
+         receiver.accept();
+      }, "stcp_socket_bench accept" );
+
+      stcp_socket sender;
+      sender.connect_to( fc::ip::endpoint( fc::ip::address( "127.0.0.1" ), server.get_port() ) );
+      accepted.wait();
+
+      std::vector<char> sent( message_size );
+      for( size_t i = 0; i < sent.size(); ++i )
+         sent[i] = char( i * 7 );
+      std::vector<char> received( message_size );
+
+      fc::future<void> reading = fc::async( [&]{
+         for( int i = 0; i < messages_to_send; ++i )
+            receiver.read( received.data(), received.size() );
+      }, "stcp_socket_bench read" );
+
+      fc::time_point start_time = fc::time_point::now();
+      for( int i = 0; i < messages_to_send; ++i )
+      {
+         sender.write( sent.data(), sent.size() );
+         sender.flush();
+      }
+      reading.wait();
+      fc::microseconds elapsed = fc::time_point::now() - start_time;
+
+      BOOST_CHECK( sent == received );
+      const uint64_t bytes = uint64_t( messages_to_send ) * message_size;
+      ilog( "Sent ${n} messages of ${s} bytes through stcp_socket in ${t} milliseconds, ${r} MiB/s",
+            ("n", messages_to_send)("s", message_size)("t", elapsed.count() / 1000)
+            ("r", double( bytes ) / ( 1024 * 1024 ) / ( double( elapsed.count() ) / 1000000 )) );
+
+      sender.close();
+      receiver.close();
+   } catch (fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
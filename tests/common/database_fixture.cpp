@@ -123,6 +123,11 @@ void database_fixture::init_genesis_state()
 }
 
 database_fixture::database_fixture()
+   : database_fixture( boost::program_options::variables_map() )
+{
+}
+
+database_fixture::database_fixture( const boost::program_options::variables_map& plugin_options )
    : app(), db( *app.chain_database() ), _dal(db)
 {
    try {
@@ -142,8 +147,6 @@ database_fixture::database_fixture()
 
    init_genesis_state();
 
-   boost::program_options::variables_map options;
-
    genesis_state.initial_timestamp = time_point_sec( GRAPHENE_TESTING_GENESIS_TIMESTAMP );
 
    genesis_state.initial_active_witnesses = 10;
@@ -162,9 +165,9 @@ database_fixture::database_fixture()
 
    // app.initialize();
    ahplugin->plugin_set_app(&app);
-   ahplugin->plugin_initialize(options);
+   ahplugin->plugin_initialize(plugin_options);
    mhplugin->plugin_set_app(&app);
-   mhplugin->plugin_initialize(options);
+   mhplugin->plugin_initialize(plugin_options);
 
    ahplugin->plugin_startup();
    mhplugin->plugin_startup();
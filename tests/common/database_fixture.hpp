@@ -182,6 +182,8 @@ struct database_fixture {
    static constexpr uint32_t apply_bonus(uint32_t value, uint32_t bonus);
 
    database_fixture();
+   /** Initializes the plugins with the given options instead of the defaults */
+   explicit database_fixture( const boost::program_options::variables_map& plugin_options );
    ~database_fixture();
 
    void init_genesis_state();
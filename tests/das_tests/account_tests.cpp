@@ -23,6 +23,7 @@
  */
 
 #include <boost/test/unit_test.hpp>
+#include <graphene/app/api.hpp>
 #include <graphene/chain/database.hpp>
 #include <graphene/chain/exceptions.hpp>
 #include <graphene/chain/hardfork.hpp>
@@ -261,5 +262,127 @@ BOOST_AUTO_TEST_CASE(update_global_parameters_test)
 
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE( dasc_holder_index_test )
+{ try {
+  ACTOR(wallet);
+  VAULT_ACTOR(vault);
+  VAULT_ACTOR(lonely);
+
+  const auto& idx = dynamic_cast<const primary_index<account_balance_index>&>(db.get_index_type<account_balance_index>());
+  const auto& ranking = idx.get_secondary_index<dasc_holder_index>().ranking();
+  const auto find_holder = [&ranking](account_id_type id) {
+    return std::find_if(ranking.begin(), ranking.end(), [id](const dasc_holder_index::holder& h) { return h.id == id; });
+  };
+
+  issue_dascoin(vault_id, 100);
+  issue_dascoin(lonely_id, 50);
+  BOOST_REQUIRE( find_holder(vault_id) != ranking.end() );
+  BOOST_CHECK_EQUAL( find_holder(vault_id)->amount.value, 100 * DASCOIN_DEFAULT_ASSET_PRECISION );
+  BOOST_CHECK( find_holder(vault_id)->amount > find_holder(lonely_id)->amount );
+  BOOST_CHECK_EQUAL( find_holder(wallet_id)->amount.value, 0 );
+
+  // A tethered vault is counted with its wallet:
+  tether_accounts(wallet_id, vault_id);
+  BOOST_CHECK( find_holder(vault_id) == ranking.end() );
+  BOOST_REQUIRE( find_holder(wallet_id) != ranking.end() );
+  BOOST_CHECK_EQUAL( find_holder(wallet_id)->vaults, 1 );
+  BOOST_CHECK_EQUAL( find_holder(wallet_id)->amount.value, 100 * DASCOIN_DEFAULT_ASSET_PRECISION );
+
+  // Moving DASC from the vault to the wallet keeps the wallet total:
+  disable_vault_to_wallet_limit(vault_id);
+  transfer_dascoin_vault_to_wallet(vault_id, wallet_id, 40 * DASCOIN_DEFAULT_ASSET_PRECISION);
+  BOOST_CHECK_EQUAL( find_holder(wallet_id)->amount.value, 100 * DASCOIN_DEFAULT_ASSET_PRECISION );
+
+  // Changes are undone with the block:
+  {
+    auto session = db._undo_db.start_undo_session();
+    db.adjust_balance(lonely_id, asset(1000 * DASCOIN_DEFAULT_ASSET_PRECISION, get_dascoin_asset_id()));
+    BOOST_CHECK_EQUAL( find_holder(lonely_id)->amount.value, 1050 * DASCOIN_DEFAULT_ASSET_PRECISION );
+  }
+  BOOST_CHECK_EQUAL( find_holder(lonely_id)->amount.value, 50 * DASCOIN_DEFAULT_ASSET_PRECISION );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( direct_balance_updates_notify_secondary_indexes_test )
+{ try {
+  struct notification_counter : public secondary_index
+  {
+    uint32_t inserted = 0, about_to_modify_count = 0, modified = 0, removed = 0;
+    virtual void object_inserted( const object& ) override { ++inserted; }
+    virtual void object_removed( const object& ) override { ++removed; }
+    virtual void about_to_modify( const object& ) override { ++about_to_modify_count; }
+    virtual void object_modified( const object& ) override { ++modified; }
+  };
+  auto& idx = const_cast<primary_index<account_balance_index>&>(
+        dynamic_cast<const primary_index<account_balance_index>&>(db.get_index_type<account_balance_index>()) );
+  const notification_counter& counter = *idx.add_secondary_index<notification_counter>();
+
+  VAULT_ACTOR(vault);
+  const uint32_t inserted = counter.inserted, modified = counter.modified, removed = counter.removed;
+
+  // Account creation leaves an empty balance behind, drop it so adjust_balance has to create one:
+  db.direct_remove<account_balance_index>( db.get_balance_object(vault_id, get_dascoin_asset_id()) );
+  BOOST_CHECK_EQUAL( counter.removed, removed + 1 );
+
+  // adjust_balance creates and modifies balances through the statically dispatched path:
+  db.adjust_balance(vault_id, asset(100, get_dascoin_asset_id()));
+  BOOST_CHECK_EQUAL( counter.inserted, inserted + 1 );
+  db.adjust_balance(vault_id, asset(50, get_dascoin_asset_id()));
+  BOOST_CHECK_EQUAL( counter.about_to_modify_count, counter.modified );
+  BOOST_CHECK_EQUAL( counter.modified, modified + 1 );
+  BOOST_CHECK_EQUAL( db.get_balance_object(vault_id, get_dascoin_asset_id()).balance.value, 150 );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( account_history_by_operation_test )
+{ try {
+  VAULT_ACTOR(foo);
+
+  auto standard_locked = *(_dal.get_license_type("standard_locked"));
+  do_op(issue_license_operation(get_license_issuer_id(), foo_id, standard_locked.id, 0, 100, db.head_block_time()));
+  for (int i = 0; i < 5; ++i)
+    do_op(issue_cycles_to_license_operation(get_cycle_issuer_id(), foo_id, standard_locked.id, 100 + i, "foo", "bar"));
+
+  graphene::app::history_api hist_api(app);
+  const auto all = hist_api.get_account_history(foo_id);
+
+  const auto filter = [&all](const flat_set<uint32_t>& types) {
+    vector<operation_history_id_type> ids;
+    for (const auto& oho : all)
+      if (types.find(oho.op.which()) != types.end())
+        ids.push_back(oho.id);
+    return ids;
+  };
+  const auto ids = [](const vector<operation_history_object>& ops) {
+    vector<operation_history_id_type> ids;
+    for (const auto& oho : ops)
+      ids.push_back(oho.id);
+    return ids;
+  };
+
+  const flat_set<uint32_t> cycles_type{ operation::tag<issue_cycles_to_license_operation>::value };
+  const flat_set<uint32_t> both_types{ operation::tag<issue_cycles_to_license_operation>::value,
+                                       operation::tag<issue_license_operation>::value };
+
+  auto expected = filter(cycles_type);
+  BOOST_REQUIRE_EQUAL( expected.size(), 5 );
+  BOOST_CHECK( ids(hist_api.get_account_history_by_operation(foo_id, cycles_type)) == expected );
+
+  expected = filter(both_types);
+  BOOST_REQUIRE_EQUAL( expected.size(), 6 );
+  BOOST_CHECK( ids(hist_api.get_account_history_by_operation(foo_id, both_types)) == expected );
+
+  // Limit, start and stop are applied to the filtered operations:
+  auto result = ids(hist_api.get_account_history_by_operation(foo_id, both_types, operation_history_id_type(), 2));
+  BOOST_CHECK( result == vector<operation_history_id_type>(expected.begin(), expected.begin() + 2) );
+
+  result = ids(hist_api.get_account_history_by_operation(foo_id, both_types, expected[4], 100, expected[1]));
+  BOOST_CHECK( result == vector<operation_history_id_type>(expected.begin() + 1, expected.begin() + 4) );
+
+  BOOST_CHECK( hist_api.get_account_history_by_operation(foo_id, both_types, expected[1], 100, expected[3]).empty() );
+  BOOST_CHECK( hist_api.get_account_history_by_operation(foo_id, { operation::tag<transfer_operation>::value }).empty() );
+
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_SUITE_END()  // account_unit_tests
 BOOST_AUTO_TEST_SUITE_END()  // dascoin_tests
@@ -0,0 +1,202 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/block_database.hpp>
+#include <graphene/chain/account_object.hpp>
+
+#include <graphene/utilities/tempdir.hpp>
+
+#include <fc/filesystem.hpp>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+BOOST_FIXTURE_TEST_SUITE( dascoin_tests, database_fixture )
+
+BOOST_FIXTURE_TEST_SUITE( block_tests, database_fixture )
+
+BOOST_AUTO_TEST_CASE( block_database_mmap_test )
+{ try {
+  fc::temp_directory data_dir( graphene::utilities::temp_directory_path() );
+
+  block_database bdb;
+  bdb.set_mmap_reads( true );
+  bdb.open( data_dir.path() );
+  BOOST_CHECK( !bdb.fetch_by_number( 1 ).valid() );
+
+  signed_block b;
+  for( uint32_t i = 0; i < 5; ++i )
+  {
+    if( i > 0 ) b.previous = b.id();
+    b.witness = witness_id_type(i+1);
+    bdb.store( b.id(), b );
+
+    // Every store grows the files past the current mapping:
+    auto fetch = bdb.fetch_by_number( b.block_num() );
+    BOOST_REQUIRE( fetch.valid() );
+    BOOST_CHECK( fetch->witness == b.witness );
+    fetch = bdb.fetch_optional( b.id() );
+    BOOST_REQUIRE( fetch.valid() );
+    BOOST_CHECK( fetch->witness == b.witness );
+    BOOST_CHECK( bdb.contains( b.id() ) );
+    BOOST_CHECK( bdb.fetch_block_id( b.block_num() ) == b.id() );
+  }
+  BOOST_CHECK( !bdb.fetch_by_number( 6 ).valid() );
+
+  bdb.remove( b.id() );
+  BOOST_CHECK( !bdb.contains( b.id() ) );
+  BOOST_CHECK( !bdb.fetch_optional( b.id() ).valid() );
+
+  // Looking for the last block drops the removed one from the index, which truncates the mapped file:
+  bdb.close();
+  bdb.open( data_dir.path() );
+  BOOST_CHECK( bdb.fetch_by_number( 4 ).valid() );
+  auto last = bdb.last();
+  BOOST_REQUIRE( last.valid() );
+  BOOST_CHECK_EQUAL( last->block_num(), 4 );
+  BOOST_CHECK( !bdb.fetch_by_number( 5 ).valid() );
+
+  for( uint32_t i = 1; i < 5; ++i )
+  {
+    auto blk = bdb.fetch_by_number( i );
+    BOOST_REQUIRE( blk.valid() );
+    BOOST_CHECK( blk->witness == witness_id_type(blk->block_num()) );
+  }
+  bdb.close();
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( incremental_flush_test )
+{ try {
+  fc::temp_directory data_dir( graphene::utilities::temp_directory_path() );
+  const genesis_state_type genesis = genesis_state;
+  auto load_genesis = [&genesis]{ return genesis; };
+  account_balance_id_type bal_id;
+  {
+    database db2;
+    db2.open( data_dir.path(), load_genesis, "test" );
+    bal_id = db2.create<account_balance_object>( [&]( account_balance_object& obj ){
+      obj.balance = 100;
+    }).id;
+    db2.flush();
+    BOOST_CHECK( !db2.get_index_type<account_balance_index>().has_unsaved_changes() );
+
+    db2.modify( bal_id(db2), [&]( account_balance_object& obj ){
+      obj.balance = 200;
+    });
+    BOOST_CHECK( db2.get_index_type<account_balance_index>().has_unsaved_changes() );
+    db2.close( false );
+  }
+  {
+    // Only the modified index was written on close, the others are loaded as they were flushed:
+    database db2;
+    db2.open( data_dir.path(), load_genesis, "test" );
+    BOOST_CHECK( !db2.get_index_type<account_balance_index>().has_unsaved_changes() );
+    BOOST_CHECK_EQUAL( bal_id(db2).balance.value, 200 );
+    db2.close( false );
+  }
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( replay_with_pipeline_test )
+{ try {
+  fc::temp_directory data_dir( graphene::utilities::temp_directory_path() );
+  const genesis_state_type genesis = genesis_state;
+  auto load_genesis = [&genesis]{ return genesis; };
+  block_id_type head_id;
+  uint32_t head_num;
+  {
+    database db2;
+    db2.open( data_dir.path(), load_genesis, "test" );
+    for( uint32_t i = 0; i < 100; ++i )
+      db2.generate_block( db2.get_slot_time(1), db2.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing );
+    head_id = db2.head_block_id();
+    head_num = db2.head_block_num();
+    db2.close( false );
+  }
+  {
+    // A new version wipes the object database, so all the blocks are replayed through the pipeline:
+    database db2;
+    db2.set_replay_threads( 4 );
+    db2.open( data_dir.path(), load_genesis, "test-replay" );
+    BOOST_CHECK_EQUAL( db2.head_block_num(), head_num );
+    BOOST_CHECK( db2.head_block_id() == head_id );
+    BOOST_CHECK( !db2.fetch_block_by_number( head_num + 1 ).valid() );
+    db2.close( false );
+  }
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( parallel_signature_recovery_test )
+{ try {
+  ACTORS((alice)(bob));
+  generate_block();
+  db.set_signature_threads( 4 );
+
+  auto make_update = [&]( const account_object& account, const fc::ecc::private_key& signer ) {
+    account_update_operation op;
+    op.account = account.id;
+    op.new_options = account.options;
+    op.new_options->memo_key = generate_private_key( account.name + "-memo" ).get_public_key();
+    signed_transaction tx;
+    set_expiration( db, tx );
+    tx.operations.push_back( op );
+    sign( tx, signer );
+    return processed_transaction( tx );
+  };
+  auto make_block = [&]( const vector<processed_transaction>& txs ) {
+    signed_block b;
+    b.previous = db.head_block_id();
+    b.timestamp = db.get_slot_time(1);
+    b.witness = db.get_scheduled_witness(1);
+    b.transactions = txs;
+    b.transaction_merkle_root = b.calculate_merkle_root();
+    b.sign( init_account_priv_key );
+    return b;
+  };
+
+  // The keys of both transactions are recovered on the signature threads. Bob's is signed by alice, which must not
+  // satisfy his authority:
+  const processed_transaction alice_update = make_update( alice, alice_private_key );
+  signed_block bad_block = make_block( { alice_update, make_update( bob, alice_private_key ) } );
+  GRAPHENE_REQUIRE_THROW( db.push_block( bad_block, database::skip_nothing ), fc::exception );
+  BOOST_CHECK( db.head_block_id() == bad_block.previous );
+  BOOST_CHECK( alice_id(db).options.memo_key == alice_public_key );
+
+  signed_block good_block = make_block( { alice_update, make_update( bob, bob_private_key ) } );
+  db.push_block( good_block, database::skip_nothing );
+  BOOST_CHECK( db.head_block_id() == good_block.id() );
+  BOOST_CHECK( alice_id(db).options.memo_key == generate_private_key( "alice-memo" ).get_public_key() );
+  BOOST_CHECK( bob_id(db).options.memo_key == generate_private_key( "bob-memo" ).get_public_key() );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -26,8 +26,10 @@
 #include <graphene/chain/database.hpp>
 #include <graphene/chain/access_layer.hpp>
 #include <graphene/chain/exceptions.hpp>
+#include <graphene/chain/hardfork.hpp>
 #include <graphene/chain/das33_object.hpp>
 #include <graphene/chain/market_object.hpp>
+#include <graphene/app/database_api.hpp>
 #include "../common/database_fixture.hpp"
 
 using namespace graphene::chain;
@@ -582,6 +584,226 @@ BOOST_AUTO_TEST_CASE( das33_complete_project_test )
 
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE( das33_batched_distribution_test )
+{ try {
+
+    ACTOR(user);
+    ACTOR(owner);
+
+    // Large distributions are only spread over several blocks after the hardfork
+    generate_blocks(HARDFORK_BLC_251_TIME);
+
+    // Create a das33 project
+    asset_id_type test_asset_id = create_new_asset("TEST", 100000000, 2, price({asset(1),asset(1,asset_id_type(1))}));
+
+    das33_project_create_operation project_create;
+        project_create.authority       = get_das33_administrator_id();
+        project_create.name            = "test_project0";
+        project_create.owner           = owner_id;
+        project_create.token           = test_asset_id;
+        project_create.discounts       = {{get_dascoin_asset_id(), 50}};
+        project_create.goal_amount_eur = 10000000;
+        project_create.min_pledge = 0;
+        project_create.max_pledge = 10000000;
+    do_op(project_create);
+
+    das33_project_object project = get_das33_projects()[0];
+
+    // More pledges than fit in a batch, in phases 0 and 1
+    const uint32_t pledges_per_phase = DAS33_DISTRIBUTION_BATCH_SIZE + 5;
+    for (uint32_t i = 0; i < 2 * pledges_per_phase; ++i)
+        db.create<das33_pledge_holder_object>([&](das33_pledge_holder_object& p){
+            p.account_id = user_id;
+            p.project_id = project.id;
+            p.pledged = p.pledge_remaining = asset{1, get_dascoin_asset_id()};
+            p.base_expected = p.base_remaining = asset{1, test_asset_id};
+            p.bonus_expected = p.bonus_remaining = asset{0, test_asset_id};
+            p.phase_number = i % 2;
+            p.timestamp = db.head_block_time();
+        });
+
+    const auto count_pledges = [this](share_type phase) {
+        const auto& idx = db.get_index_type<das33_pledge_holder_index>().indices().get<by_project_phase>();
+        const auto range = idx.equal_range(boost::make_tuple(get_das33_projects()[0].id, phase));
+        return static_cast<size_t>(std::distance(range.first, range.second));
+    };
+    const auto& distributions = db.get_index_type<das33_distribution_index>().indices();
+
+    // The operation distributes a single batch of phase 0 pledges
+    push_op_no_balance_check(das33_distribute_project_pledges_operation(get_das33_administrator_id(), project.id, 0, 10000, 10000, 10000));
+    BOOST_CHECK_EQUAL(count_pledges(0), pledges_per_phase - DAS33_DISTRIBUTION_BATCH_SIZE);
+    BOOST_CHECK_EQUAL(count_pledges(1), pledges_per_phase);
+    BOOST_CHECK_EQUAL(distributions.size(), 1);
+    BOOST_CHECK_EQUAL(get_balance(user_id, test_asset_id), DAS33_DISTRIBUTION_BATCH_SIZE);
+
+    // The rest is distributed when the block is applied, phase 1 is left alone
+    generate_block();
+    BOOST_CHECK_EQUAL(count_pledges(0), 0);
+    BOOST_CHECK_EQUAL(count_pledges(1), pledges_per_phase);
+    BOOST_CHECK_EQUAL(distributions.size(), 0);
+    BOOST_CHECK_EQUAL(get_balance(user_id, test_asset_id), pledges_per_phase);
+    BOOST_CHECK_EQUAL(get_balance(owner_id, get_dascoin_asset_id()), pledges_per_phase);
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( das33_pledge_totals_test )
+{ try {
+
+    ACTOR(user);
+    ACTOR(owner);
+    VAULT_ACTOR(vault);
+
+    tether_accounts(user_id, vault_id);
+
+    // Issue a bunch of assets
+    issue_dascoin(vault_id, 100);
+    disable_vault_to_wallet_limit(vault_id);
+    transfer_dascoin_vault_to_wallet(vault_id, user_id, 100 * DASCOIN_DEFAULT_ASSET_PRECISION);
+
+    // Create a das33 project
+    asset_id_type test_asset_id = create_new_asset("TEST", 100000000, 2, price({asset(1),asset(1,asset_id_type(1))}));
+
+    das33_project_create_operation project_create;
+        project_create.authority       = get_das33_administrator_id();
+        project_create.name            = "test_project0";
+        project_create.owner           = owner_id;
+        project_create.token           = test_asset_id;
+        project_create.discounts       = {{get_dascoin_asset_id(), 50}};
+        project_create.goal_amount_eur = 10000000;
+        project_create.min_pledge = 0;
+        project_create.max_pledge = 10000000;
+    do_op(project_create);
+
+    das33_project_object project = get_das33_projects()[0];
+
+    // Activate project
+    das33_project_update_operation project_update;
+        project_update.project_id = project.id;
+        project_update.authority  = get_das33_administrator_id();
+        project_update.status     = das33_project_status::active;
+    do_op(project_update);
+
+    const auto& pledge_idx = dynamic_cast<const primary_index<das33_pledge_holder_index>&>(db.get_index_type<das33_pledge_holder_index>());
+    const auto& totals = pledge_idx.get_secondary_index<das33_pledge_totals_index>();
+    BOOST_CHECK(totals.find(project.id) == nullptr);
+
+    // Two pledges in phase 0 and one in phase 1
+    const share_type amount = 10 * DASCOIN_DEFAULT_ASSET_PRECISION;
+    do_op_no_balance_check(das33_pledge_asset_operation(user_id, asset{amount, get_dascoin_asset_id()}, optional<license_type_id_type>{}, project.id));
+    do_op_no_balance_check(das33_pledge_asset_operation(user_id, asset{amount, get_dascoin_asset_id()}, optional<license_type_id_type>{}, project.id));
+
+    das33_project_update_operation project_update_phase;
+        project_update_phase.project_id = project.id;
+        project_update_phase.authority  = get_das33_administrator_id();
+        project_update_phase.phase_number = 1;
+    do_op_no_balance_check(project_update_phase);
+    do_op_no_balance_check(das33_pledge_asset_operation(user_id, asset{amount, get_dascoin_asset_id()}, optional<license_type_id_type>{}, project.id));
+
+    const auto* project_totals = totals.find(project.id);
+    BOOST_REQUIRE(project_totals != nullptr);
+    BOOST_CHECK_EQUAL(project_totals->pledged.at(get_dascoin_asset_id()).value, 3 * amount.value);
+    BOOST_CHECK_EQUAL(project_totals->pledged_by_phase.at(0).at(get_dascoin_asset_id()).value, 2 * amount.value);
+    BOOST_CHECK_EQUAL(project_totals->pledged_by_phase.at(1).at(get_dascoin_asset_id()).value, amount.value);
+
+    const auto pledges = get_das33_pledges();
+    const auto* account_totals = totals.find(user_id);
+    BOOST_REQUIRE(account_totals != nullptr);
+    const auto& phases = account_totals->at(project.id);
+    BOOST_CHECK_EQUAL(phases.at(0).count, 2);
+    BOOST_CHECK_EQUAL(phases.at(0).base.value, pledges[0].base_expected.amount.value + pledges[1].base_expected.amount.value);
+    BOOST_CHECK_EQUAL(phases.at(1).bonus.value, pledges[2].bonus_expected.amount.value);
+
+    // Totals follow the undo of a removed pledge
+    {
+       auto session = db._undo_db.start_undo_session();
+       db.remove(db.get_object(pledges[2].id));
+       BOOST_CHECK(totals.find(project.id)->pledged_by_phase.count(1) == 0);
+       BOOST_CHECK(totals.find(user_id)->at(project.id).count(1) == 0);
+    }
+    BOOST_CHECK_EQUAL(totals.find(project.id)->pledged_by_phase.at(1).at(get_dascoin_asset_id()).value, amount.value);
+    BOOST_CHECK_EQUAL(totals.find(user_id)->at(project.id).at(1).count, 1);
+
+    // Distributed pledges are no longer counted
+    do_op_no_balance_check(das33_distribute_project_pledges_operation(get_das33_administrator_id(), project.id, 0, 10000, 10000, 10000));
+    BOOST_CHECK_EQUAL(totals.find(project.id)->pledged.at(get_dascoin_asset_id()).value, amount.value);
+    BOOST_CHECK(totals.find(project.id)->pledged_by_phase.count(0) == 0);
+    do_op_no_balance_check(das33_distribute_project_pledges_operation(get_das33_administrator_id(), project.id, 1, 10000, 10000, 10000));
+    BOOST_CHECK(totals.find(project.id) == nullptr);
+    BOOST_CHECK(totals.find(user_id) == nullptr);
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( das33_pledge_totals_api_test )
+{ try {
+
+    ACTOR(user);
+    ACTOR(owner);
+
+    asset_id_type test_asset_id = create_new_asset("TEST", 100000000, 2, price({asset(1),asset(1,asset_id_type(1))}));
+
+    das33_project_create_operation project_create;
+        project_create.authority       = get_das33_administrator_id();
+        project_create.name            = "test_project0";
+        project_create.owner           = owner_id;
+        project_create.token           = test_asset_id;
+        project_create.discounts       = {{get_dascoin_asset_id(), 50}};
+        project_create.goal_amount_eur = 10000000;
+        project_create.min_pledge = 0;
+        project_create.max_pledge = 10000000;
+    do_op(project_create);
+
+    das33_project_object project = get_das33_projects()[0];
+    graphene::app::database_api db_api(db);
+
+    auto create_pledge = [&](share_type amount, share_type base) -> const das33_pledge_holder_object& {
+        return db.create<das33_pledge_holder_object>([&](das33_pledge_holder_object& p){
+            p.account_id = user_id;
+            p.project_id = project.id;
+            p.pledged = p.pledge_remaining = asset{amount, get_dascoin_asset_id()};
+            p.base_expected = p.base_remaining = asset{base, test_asset_id};
+            p.bonus_expected = p.bonus_remaining = asset{0, test_asset_id};
+            p.phase_number = 0;
+            p.timestamp = db.head_block_time();
+        });
+    };
+
+    // A zero amount pledge is listed, but does not show up in the pledged amounts
+    const auto& zero_pledge = create_pledge(0, 0);
+    BOOST_CHECK(db_api.get_amount_of_assets_pledged_to_project(project.id).empty());
+    BOOST_CHECK(db_api.get_amount_of_assets_pledged_to_project_in_phase(project.id, 0).empty());
+    BOOST_CHECK_EQUAL(db_api.get_das33_pledges_by_account(user_id).pledges.size(), 1);
+
+    const auto& pledge = create_pledge(1000, 50);
+    auto pledged = db_api.get_amount_of_assets_pledged_to_project(project.id);
+    BOOST_REQUIRE_EQUAL(pledged.size(), 1);
+    BOOST_CHECK(pledged[0] == asset(1000, get_dascoin_asset_id()));
+    pledged = db_api.get_amount_of_assets_pledged_to_project_in_phase(project.id, 0);
+    BOOST_REQUIRE_EQUAL(pledged.size(), 1);
+    BOOST_CHECK(pledged[0] == asset(1000, get_dascoin_asset_id()));
+    BOOST_CHECK(db_api.get_amount_of_assets_pledged_to_project_in_phase(project.id, 1).empty());
+
+    auto by_account = db_api.get_das33_pledges_by_account(user_id);
+    BOOST_CHECK_EQUAL(by_account.pledges.size(), 2);
+    BOOST_CHECK_EQUAL(by_account.total_expected.at(project.id).value, 50);
+    BOOST_CHECK_EQUAL(by_account.base_expected_in_last_round.at(project.id).value, 50);
+
+    // Removing the pledge with an amount leaves the zero amount one in place
+    db.remove(pledge);
+    BOOST_CHECK(db_api.get_amount_of_assets_pledged_to_project(project.id).empty());
+    BOOST_CHECK(db_api.get_amount_of_assets_pledged_to_project_in_phase(project.id, 0).empty());
+    by_account = db_api.get_das33_pledges_by_account(user_id);
+    BOOST_CHECK_EQUAL(by_account.pledges.size(), 1);
+    BOOST_CHECK_EQUAL(by_account.total_expected.at(project.id).value, 0);
+
+    // Then the zero amount pledge can be removed too
+    db.remove(zero_pledge);
+    by_account = db_api.get_das33_pledges_by_account(user_id);
+    BOOST_CHECK(by_account.pledges.empty());
+    BOOST_CHECK(by_account.total_expected.empty());
+    BOOST_CHECK(db_api.get_amount_of_assets_pledged_to_project(project.id).empty());
+
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_CASE( das33_reject_project_test )
 { try {
 
@@ -27,12 +27,31 @@
 #include <graphene/chain/database.hpp>
 #include <graphene/chain/exceptions.hpp>
 #include <graphene/chain/market_object.hpp>
+#include <graphene/market_history/market_history_plugin.hpp>
 
 #include "../common/database_fixture.hpp"
 
 using namespace graphene::chain;
 using namespace graphene::chain::test;
 
+namespace {
+
+/// Keeps a single fill per market in the order history, however old it is
+struct market_history_single_record_fixture : database_fixture
+{
+  market_history_single_record_fixture() : database_fixture( plugin_options() ) {}
+
+  static boost::program_options::variables_map plugin_options()
+  {
+    boost::program_options::variables_map options;
+    options.emplace( "max-order-his-records-per-market", boost::program_options::variable_value( uint32_t(1), false ) );
+    options.emplace( "max-order-his-seconds-per-market", boost::program_options::variable_value( uint32_t(0), false ) );
+    return options;
+  }
+};
+
+}
+
 BOOST_FIXTURE_TEST_SUITE( dascoin_tests, database_fixture )
 
 BOOST_FIXTURE_TEST_SUITE( exchange_unit_tests, database_fixture )
@@ -200,6 +219,55 @@ BOOST_AUTO_TEST_CASE( cancel_order_test )
 
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE( price_level_index_test )
+{ try {
+    ACTOR(alice);
+
+    issue_webasset("1", alice_id, 100, 100);
+    generate_blocks(db.head_block_time() + fc::hours(24) + fc::seconds(1));
+    set_expiration( db, trx );
+
+    const auto& idx = dynamic_cast<const primary_index<limit_order_index>&>(db.get_index_type<limit_order_index>());
+    const auto& levels = idx.get_secondary_index<limit_order_price_level_index>().levels();
+    BOOST_CHECK( levels.empty() );
+
+    // Two orders at the same price and one at a different price:
+    auto order1 = create_sell_order(alice_id, asset{40, get_web_asset_id()}, asset{40, get_dascoin_asset_id()});
+    auto order2 = create_sell_order(alice_id, asset{20, get_web_asset_id()}, asset{20, get_dascoin_asset_id()});
+    auto order3 = create_sell_order(alice_id, asset{0, get_web_asset_id()}, asset{50, get_dascoin_asset_id()}, 25);
+    BOOST_REQUIRE_EQUAL( levels.size(), 2 );
+
+    const auto& level = levels.at(order1->sell_price);
+    BOOST_CHECK_EQUAL( level.count, 2 );
+    BOOST_CHECK_EQUAL( level.for_sale.value, 60 );
+    BOOST_CHECK_EQUAL( level.quote_volume.value,
+                       limit_order_price_level_index::rounded_quote_amount(*order1).value +
+                       limit_order_price_level_index::rounded_quote_amount(*order2).value );
+    BOOST_CHECK_EQUAL( levels.at(order3->sell_price).count, 1 );
+
+    // The level goes away with its last order:
+    cancel_limit_order(*order1);
+    BOOST_CHECK_EQUAL( levels.at(order2->sell_price).count, 1 );
+    BOOST_CHECK_EQUAL( levels.at(order2->sell_price).for_sale.value, 20 );
+    cancel_limit_order(*order2);
+    cancel_limit_order(*order3);
+    BOOST_CHECK( levels.empty() );
+
+    // Orders restored by undo are aggregated again:
+    set_expiration( db, trx );
+    order1 = create_sell_order(alice_id, asset{40, get_web_asset_id()}, asset{40, get_dascoin_asset_id()});
+    generate_block();
+    BOOST_REQUIRE_EQUAL( levels.size(), 1 );
+    {
+       auto session = db._undo_db.start_undo_session();
+       db.remove(*order1);
+       BOOST_CHECK( levels.empty() );
+    }
+    BOOST_REQUIRE_EQUAL( levels.size(), 1 );
+    BOOST_CHECK_EQUAL( levels.begin()->second.for_sale.value, 40 );
+
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_CASE( exchange_test )
 { try {
     ACTOR(alicew);
@@ -291,6 +359,119 @@ BOOST_AUTO_TEST_CASE( exchange_test )
 
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE( market_ticker_test )
+{ try {
+    ACTOR(alicew);
+    ACTOR(bobw);
+    VAULT_ACTOR(bob);
+    VAULT_ACTOR(alice);
+
+    issue_webasset("1", alice_id, 1000, 100);
+    issue_dascoin(bob_id, 100);
+    tether_accounts(bobw_id, bob_id);
+    tether_accounts(alicew_id, alice_id);
+    db.adjust_balance_limit(bob, get_dascoin_asset_id(), 100 * DASCOIN_DEFAULT_ASSET_PRECISION);
+    transfer_dascoin_vault_to_wallet(bob_id, bobw_id, 100 * DASCOIN_DEFAULT_ASSET_PRECISION);
+    transfer_webasset_vault_to_wallet(alice_id, alicew_id, {1000, 100});
+
+    // Two trades at different prices, alice is the maker of both:
+    set_expiration( db, trx );
+    create_sell_order(alicew_id, asset{1 * DASCOIN_FIAT_ASSET_PRECISION, get_web_asset_id()},
+                      asset{10 * DASCOIN_DEFAULT_ASSET_PRECISION, get_dascoin_asset_id()});
+    create_sell_order(bobw_id, asset{10 * DASCOIN_DEFAULT_ASSET_PRECISION, get_dascoin_asset_id()},
+                      asset{1 * DASCOIN_FIAT_ASSET_PRECISION, get_web_asset_id()});
+    create_sell_order(alicew_id, asset{2 * DASCOIN_FIAT_ASSET_PRECISION, get_web_asset_id()},
+                      asset{10 * DASCOIN_DEFAULT_ASSET_PRECISION, get_dascoin_asset_id()});
+    create_sell_order(bobw_id, asset{10 * DASCOIN_DEFAULT_ASSET_PRECISION, get_dascoin_asset_id()},
+                      asset{2 * DASCOIN_FIAT_ASSET_PRECISION, get_web_asset_id()});
+    generate_block();
+
+    const auto base_id = std::min(get_web_asset_id(), get_dascoin_asset_id());
+    const auto quote_id = std::max(get_web_asset_id(), get_dascoin_asset_id());
+    const auto& ticker_idx = db.get_index_type<graphene::market_history::market_ticker_index>()
+                                .indices().get<graphene::market_history::by_market>();
+    auto itr = ticker_idx.find( std::make_tuple( base_id, quote_id ) );
+    BOOST_REQUIRE( itr != ticker_idx.end() );
+    const auto& ticker = *itr;
+
+    BOOST_CHECK_EQUAL( ticker.trade_count, 2 );
+    const share_type web_volume = base_id == get_web_asset_id() ? ticker.base_volume : ticker.quote_volume;
+    const share_type dascoin_volume = base_id == get_web_asset_id() ? ticker.quote_volume : ticker.base_volume;
+    BOOST_CHECK_EQUAL( web_volume.value, 3 * DASCOIN_FIAT_ASSET_PRECISION );
+    BOOST_CHECK_EQUAL( dascoin_volume.value, 20 * DASCOIN_DEFAULT_ASSET_PRECISION );
+    BOOST_CHECK( ticker.low < ticker.high );
+    BOOST_CHECK( !ticker.previous_price.valid() );
+
+    // Once a day has passed the trades leave the window:
+    generate_blocks(db.head_block_time() + fc::hours(24) + fc::seconds(1));
+    generate_block();
+    BOOST_CHECK_EQUAL( ticker.trade_count, 0 );
+    BOOST_CHECK_EQUAL( ticker.base_volume.value, 0 );
+    BOOST_CHECK_EQUAL( ticker.quote_volume.value, 0 );
+    BOOST_REQUIRE( ticker.previous_price.valid() );
+    BOOST_CHECK( *ticker.previous_price == ticker.latest_price );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_FIXTURE_TEST_CASE( market_ticker_order_history_pruning_test, market_history_single_record_fixture )
+{ try {
+    ACTOR(alicew);
+    ACTOR(bobw);
+    VAULT_ACTOR(bob);
+    VAULT_ACTOR(alice);
+
+    issue_webasset("1", alice_id, 1000, 100);
+    issue_dascoin(bob_id, 100);
+    tether_accounts(bobw_id, bob_id);
+    tether_accounts(alicew_id, alice_id);
+    db.adjust_balance_limit(bob, get_dascoin_asset_id(), 100 * DASCOIN_DEFAULT_ASSET_PRECISION);
+    transfer_dascoin_vault_to_wallet(bob_id, bobw_id, 100 * DASCOIN_DEFAULT_ASSET_PRECISION);
+    transfer_webasset_vault_to_wallet(alice_id, alicew_id, {1000, 100});
+
+    auto trade = [&]() {
+      set_expiration( db, trx );
+      create_sell_order(alicew_id, asset{1 * DASCOIN_FIAT_ASSET_PRECISION, get_web_asset_id()},
+                        asset{10 * DASCOIN_DEFAULT_ASSET_PRECISION, get_dascoin_asset_id()});
+      create_sell_order(bobw_id, asset{10 * DASCOIN_DEFAULT_ASSET_PRECISION, get_dascoin_asset_id()},
+                        asset{1 * DASCOIN_FIAT_ASSET_PRECISION, get_web_asset_id()});
+    };
+    const auto& history_idx = db.get_index_type<graphene::market_history::history_index>().indices();
+
+    // Two trades of a maker and a taker fill each, in separate blocks of the same day:
+    trade();
+    generate_block();
+    trade();
+    generate_block();
+
+    const auto base_id = std::min(get_web_asset_id(), get_dascoin_asset_id());
+    const auto quote_id = std::max(get_web_asset_id(), get_dascoin_asset_id());
+    const auto& ticker_idx = db.get_index_type<graphene::market_history::market_ticker_index>()
+                                .indices().get<graphene::market_history::by_market>();
+    auto itr = ticker_idx.find( std::make_tuple( base_id, quote_id ) );
+    BOOST_REQUIRE( itr != ticker_idx.end() );
+    const auto& ticker = *itr;
+
+    // Both limits are exceeded, but the fills in the window of the ticker are kept:
+    BOOST_CHECK_EQUAL( history_idx.size(), 4 );
+    BOOST_CHECK_EQUAL( ticker.trade_count, 2 );
+
+    // Once a day has passed both trades are subtracted from the ticker:
+    generate_blocks(db.head_block_time() + fc::hours(24) + fc::seconds(1));
+    generate_block();
+    BOOST_CHECK_EQUAL( ticker.trade_count, 0 );
+    BOOST_CHECK_EQUAL( ticker.base_volume.value, 0 );
+    BOOST_CHECK_EQUAL( ticker.quote_volume.value, 0 );
+
+    // The next fill prunes the expired ones:
+    trade();
+    generate_block();
+    BOOST_CHECK_EQUAL( history_idx.size(), 2 );
+    BOOST_CHECK_EQUAL( ticker.trade_count, 1 );
+    const share_type web_volume = base_id == get_web_asset_id() ? ticker.base_volume : ticker.quote_volume;
+    BOOST_CHECK_EQUAL( web_volume.value, 1 * DASCOIN_FIAT_ASSET_PRECISION );
+
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_CASE( account_to_credit_test )
 { try {
     ACTOR(alice);
@@ -0,0 +1,244 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <boost/test/unit_test.hpp>
+
+#include <graphene/account_history/account_history_plugin.hpp>
+#include <graphene/account_history/history_store.hpp>
+#include <graphene/app/api.hpp>
+#include <graphene/utilities/tempdir.hpp>
+
+#include <fc/filesystem.hpp>
+
+#include <boost/filesystem/path.hpp>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+using graphene::account_history::history_store;
+
+namespace {
+
+struct history_store_dir
+{
+  history_store_dir() : history_dir( graphene::utilities::temp_directory_path() ) {}
+  fc::temp_directory history_dir;
+};
+
+/// Keeps the history of the last 5 blocks in memory, the directory of the store is created before the plugins
+struct history_memory_window_fixture : history_store_dir, database_fixture
+{
+  history_memory_window_fixture() : database_fixture( plugin_options( history_dir.path() ) ) {}
+
+  static boost::program_options::variables_map plugin_options( const fc::path& dir )
+  {
+    boost::program_options::variables_map options;
+    options.emplace( "history-memory-window", boost::program_options::variable_value( uint32_t(5), false ) );
+    options.emplace( "history-store-dir",
+                     boost::program_options::variable_value( boost::filesystem::path( dir.generic_string() ), false ) );
+    return options;
+  }
+};
+
+}
+
+BOOST_FIXTURE_TEST_SUITE( dascoin_tests, database_fixture )
+
+BOOST_FIXTURE_TEST_SUITE( history_store_tests, database_fixture )
+
+BOOST_AUTO_TEST_CASE( history_store_test )
+{ try {
+  fc::temp_directory dir( graphene::utilities::temp_directory_path() );
+  const account_id_type alice(100), bob(101);
+
+  history_store store;
+  store.open( dir.path() );
+  BOOST_CHECK_EQUAL( store.next_operation(), 0 );
+
+  // Operation 5 never made it into the history, bob takes part in every third operation:
+  uint32_t alice_seq = 0, bob_seq = 0;
+  uint64_t entry_id = 0;
+  for( uint32_t i = 0; i < 250; ++i )
+  {
+    if( i == 5 )
+      continue;
+    operation_history_object op;
+    op.id = operation_history_id_type(i);
+    op.block_num = i;
+    store.append( op );
+
+    account_transaction_history_object entry;
+    entry.id = account_transaction_history_id_type(entry_id++);
+    entry.account = alice;
+    entry.operation_id = op.id;
+    entry.sequence = ++alice_seq;
+    store.append( entry );
+    if( i % 3 == 0 )
+    {
+      entry.id = account_transaction_history_id_type(entry_id++);
+      entry.account = bob;
+      entry.sequence = ++bob_seq;
+      store.append( entry );
+    }
+  }
+
+  // Operations and entries which are stored already are ignored:
+  operation_history_object old_op;
+  old_op.id = operation_history_id_type(10);
+  old_op.block_num = 1000;
+  store.append( old_op );
+  account_transaction_history_object old_entry;
+  old_entry.account = alice;
+  old_entry.sequence = 3;
+  store.append( old_entry );
+
+  const auto check_store = [&]( uint32_t operations ) {
+    BOOST_CHECK_EQUAL( store.next_operation(), operations );
+    BOOST_CHECK( !store.get_operation( operation_history_id_type(5) ).valid() );
+    BOOST_CHECK( !store.get_operation( operation_history_id_type(operations) ).valid() );
+    for( uint32_t i : { 0u, 10u, 99u, operations - 1 } )
+    {
+      auto op = store.get_operation( operation_history_id_type(i) );
+      BOOST_REQUIRE( op.valid() );
+      BOOST_CHECK( op->id == operation_history_id_type(i) );
+      BOOST_CHECK_EQUAL( op->block_num, i );
+    }
+
+    // Alice's entries are read back from any sequence, most recent first:
+    BOOST_CHECK_EQUAL( store.last_sequence( alice ), operations - 1 );
+    for( uint32_t sequence : { 1u, 99u, 100u, 101u, 150u, operations - 1 } )
+    {
+      auto entries = store.get_account_history( alice, sequence, 120 );
+      BOOST_REQUIRE_EQUAL( entries.size(), std::min( sequence, 120u ) );
+      for( const auto& entry : entries )
+      {
+        BOOST_CHECK( entry.account == alice );
+        BOOST_CHECK_EQUAL( entry.sequence, sequence );
+        // Operation 5 is missing, so the sequences after it are one behind:
+        BOOST_CHECK_EQUAL( entry.operation_id.instance.value, sequence <= 5 ? sequence - 1 : sequence );
+        --sequence;
+      }
+    }
+
+    auto entries = store.get_account_history( bob, 1000, 5 );
+    BOOST_REQUIRE_EQUAL( entries.size(), 5 );
+    BOOST_CHECK_EQUAL( entries.front().sequence, store.last_sequence( bob ) );
+    BOOST_CHECK_EQUAL( entries.back().sequence, store.last_sequence( bob ) - 4 );
+
+    BOOST_CHECK( store.get_account_history( account_id_type(102), 1, 10 ).empty() );
+  };
+
+  check_store( 250 );
+
+  // Positions are rebuilt when the store is opened again:
+  store.close();
+  store.open( dir.path() );
+  check_store( 250 );
+
+  // Truncating drops the operations from the given one, and the entries which refer to them:
+  store.truncate( operation_history_id_type(200) );
+  check_store( 200 );
+  BOOST_CHECK_EQUAL( store.last_sequence( bob ), 67 );
+
+  store.close();
+  store.open( dir.path() );
+  check_store( 200 );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_FIXTURE_TEST_CASE( history_memory_window_test, history_memory_window_fixture )
+{ try {
+  ACTOR(alice);
+  for( uint32_t i = 0; i < 30; ++i )
+  {
+    account_update_operation op;
+    op.account = alice_id;
+    op.new_options = alice_id(db).options;
+    op.new_options->memo_key = generate_private_key( "memo" + fc::to_string( uint64_t(i) ) ).get_public_key();
+    do_op( op );
+  }
+
+  auto plugin = app.get_plugin<graphene::account_history::account_history_plugin>( "account_history" );
+  const history_store* store = plugin->store();
+  BOOST_REQUIRE( store != nullptr );
+
+  // The older part of alice's history has moved to the store, the recent blocks are still in memory:
+  const uint32_t total = alice_id(db).statistics(db).total_ops;
+  const uint32_t stored = store->last_sequence( alice_id );
+  BOOST_REQUIRE_GT( total, 30 );
+  BOOST_REQUIRE_GT( stored, 1 );
+  BOOST_REQUIRE_LT( stored, total );
+  const auto& by_seq_idx = db.get_index_type<account_transaction_history_index>().indices().get<by_seq>();
+  BOOST_CHECK( by_seq_idx.find( boost::make_tuple( alice_id, stored ) ) == by_seq_idx.end() );
+  BOOST_CHECK( by_seq_idx.find( boost::make_tuple( alice_id, stored + 1 ) ) != by_seq_idx.end() );
+
+  graphene::app::history_api hist_api(app);
+
+  // Pages by sequence number cross from memory into the store without gaps:
+  vector<operation_history_object> relative;
+  for( uint32_t start = total; start > 1; )
+  {
+    auto page = hist_api.get_relative_account_history( alice_id, 0, 7, start );
+    BOOST_REQUIRE( !page.empty() );
+    relative.insert( relative.end(), page.begin(), page.end() );
+    start -= page.size();
+  }
+  // The entry with sequence 1 is never returned by get_relative_account_history:
+  BOOST_REQUIRE_EQUAL( relative.size(), total - 1 );
+  for( size_t i = 1; i < relative.size(); ++i )
+    BOOST_CHECK( relative[i].id.instance() < relative[i-1].id.instance() );
+
+  // Pages by operation id return the same operations:
+  vector<operation_history_object> absolute;
+  operation_history_id_type start;
+  while( true )
+  {
+    auto page = hist_api.get_account_history( alice_id, operation_history_id_type(), 7, start );
+    if( page.empty() )
+      break;
+    absolute.insert( absolute.end(), page.begin(), page.end() );
+    if( page.back().id.instance() <= 1 )
+      break;
+    start = operation_history_id_type( page.back().id.instance() - 1 );
+  }
+  BOOST_REQUIRE_EQUAL( absolute.size(), total );
+  for( size_t i = 0; i < relative.size(); ++i )
+    BOOST_CHECK( absolute[i].id == relative[i].id );
+
+  // Flushing the database makes the store durable as well:
+  db.flush();
+  history_store reopened;
+  reopened.open( history_dir.path() );
+  BOOST_CHECK_EQUAL( reopened.next_operation(), store->next_operation() );
+  BOOST_CHECK_EQUAL( reopened.last_sequence( alice_id ), stored );
+  BOOST_CHECK_EQUAL( reopened.get_account_history( alice_id, stored, 100 ).size(), stored );
+  reopened.close();
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -27,6 +27,7 @@
 #include <graphene/chain/protocol/license.hpp>
 #include <graphene/chain/database.hpp>
 #include <graphene/chain/exceptions.hpp>
+#include <graphene/chain/hardfork.hpp>
 
 #include <graphene/chain/account_object.hpp>
 #include <graphene/chain/frequency_history_record_object.hpp>
@@ -899,6 +900,72 @@ BOOST_AUTO_TEST_CASE( upgrade_executed_test )
 
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE( upgrade_executed_in_batches_test )
+{ try {
+  // Upgrade events only visit licensed vaults, in batches, after the hardfork:
+  generate_blocks(HARDFORK_BLC_258_TIME);
+  db.set_upgrade_batch_size(1);
+
+  VAULT_ACTOR(foo);
+  VAULT_ACTOR(bar);
+  VAULT_ACTOR(foobar);
+  VAULT_ACTOR(baz);
+
+  auto standard_locked = *(_dal.get_license_type("standard_locked"));
+  auto manager_locked = *(_dal.get_license_type("manager_locked"));
+  const time_point_sec activated_time = db.head_block_time();
+  const auto& dgpo = db.get_dynamic_global_properties();
+  const auto& gpo = db.get_global_properties();
+  const auto license_administrator_id = gpo.authorities.license_administrator;
+
+  do_op(issue_license_operation(get_license_issuer_id(), foo_id, standard_locked.id, 0, 100, activated_time));
+  do_op(issue_license_operation(get_license_issuer_id(), bar_id, manager_locked.id, 0, 100, activated_time));
+  do_op(issue_license_operation(get_license_issuer_id(), foobar_id, standard_locked.id, 0, 100, activated_time));
+
+  // With a subsequent execution the event is not done after the first one, so it can still be updated afterwards:
+  const time_point_sec execution_time = dgpo.next_maintenance_time;
+  do_op(create_upgrade_event_operation(license_administrator_id, execution_time, {},
+                                       vector<time_point_sec>{execution_time + 2 * gpo.parameters.maintenance_interval},
+                                       "foo_upgrade"));
+  const upgrade_event_object& upgrade = *db.get_index_type<upgrade_event_index>().indices().get<by_id>().begin();
+
+  generate_blocks(execution_time);
+
+  // One licensed vault per block, so the execution spans several blocks:
+  BOOST_CHECK_EQUAL( upgrade.num_of_executions, 1 );
+  BOOST_CHECK( upgrade.cursor.valid() );
+
+  // The event cannot be updated nor deleted while it is being executed:
+  GRAPHENE_REQUIRE_THROW( push_op(update_upgrade_event_operation(license_administrator_id, upgrade.id, {}, {}, {},
+                                                                 string("bar_upgrade"))), fc::exception );
+  GRAPHENE_REQUIRE_THROW( push_op(delete_upgrade_event_operation(license_administrator_id, upgrade.id)), fc::exception );
+
+  uint32_t blocks = 1;
+  while( upgrade.cursor.valid() && blocks < 10 )
+  {
+    generate_block();
+    ++blocks;
+  }
+  BOOST_CHECK( !upgrade.cursor.valid() );
+  BOOST_CHECK_EQUAL( blocks, 3 );
+  BOOST_CHECK( !upgrade.executed() );
+
+  BOOST_CHECK_EQUAL( get_cycle_balance(foo_id).value, 2 * DASCOIN_BASE_STANDARD_CYCLES );
+  BOOST_CHECK_EQUAL( get_cycle_balance(bar_id).value, 2 * DASCOIN_BASE_MANAGER_CYCLES );
+  BOOST_CHECK_EQUAL( get_cycle_balance(foobar_id).value, 2 * DASCOIN_BASE_STANDARD_CYCLES );
+  // A vault without a license is not touched:
+  BOOST_CHECK_EQUAL( get_cycle_balance(baz_id).value, 0 );
+
+  // Once the execution is done the event can be updated again:
+  do_op(update_upgrade_event_operation(license_administrator_id, upgrade.id, {}, {}, {}, string("bar_upgrade")));
+  BOOST_CHECK_EQUAL( upgrade.comment, "bar_upgrade" );
+
+  // And deleted:
+  do_op(delete_upgrade_event_operation(license_administrator_id, upgrade.id));
+  BOOST_CHECK( db.get_index_type<upgrade_event_index>().indices().empty() );
+
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_CASE( update_license_unit_test )
 { try {
   VAULT_ACTOR(vault);
@@ -1153,6 +1220,65 @@ BOOST_AUTO_TEST_CASE( submit_cycles_to_queue_from_charter_license_test )
 
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE( license_totals_index_test )
+{ try {
+  VAULT_ACTOR(foo);
+  VAULT_ACTOR(bar);
+  VAULT_ACTOR(foobar);
+
+  const auto& idx = dynamic_cast<const primary_index<license_information_index>&>(db.get_index_type<license_information_index>());
+  const auto& totals = idx.get_secondary_index<license_totals_index>();
+
+  const auto check_totals = [&]() {
+    total_cycles_res expected;
+    for (const auto& id : { foo_id, bar_id, foobar_id })
+    {
+      auto vault_cycles = _dal.get_total_cycles(id);
+      if (vault_cycles.valid())
+      {
+        expected.total_cycles += vault_cycles->total_cycles;
+        expected.total_dascoin += vault_cycles->total_dascoin;
+      }
+    }
+    BOOST_CHECK_EQUAL( totals.total_cycles().value, expected.total_cycles.value );
+    BOOST_CHECK_EQUAL( totals.total_dascoin().value, expected.total_dascoin.value );
+  };
+
+  auto standard_locked = *(_dal.get_license_type("standard_locked"));
+  auto executive_locked = *(_dal.get_license_type("executive_locked"));
+  auto standard_utility = *(_dal.get_license_type("standard_utility"));
+  auto standard_charter = *(_dal.get_license_type("standard_charter"));
+  const time_point_sec issue_time = db.head_block_time();
+
+  BOOST_CHECK_EQUAL( totals.total_cycles().value, 0 );
+  BOOST_CHECK_EQUAL( totals.total_dascoin().value, 0 );
+
+  do_op(issue_license_operation(get_license_issuer_id(), foo_id, standard_locked.id, 0, 100, issue_time));
+  do_op(issue_license_operation(get_license_issuer_id(), foo_id, executive_locked.id, 0, 150, issue_time));
+  do_op(issue_license_operation(get_license_issuer_id(), bar_id, standard_utility.id, 50, 200, issue_time));
+  BOOST_CHECK_GT( totals.total_cycles().value, 0 );
+  check_totals();
+
+  // Chartered licenses are not submitted manually, so they are not counted:
+  const auto before = totals.total_cycles();
+  do_op(issue_license_operation(get_license_issuer_id(), foobar_id, standard_charter.id, 0, 100, issue_time));
+  BOOST_CHECK_EQUAL( totals.total_cycles().value, before.value );
+  check_totals();
+
+  do_op(submit_cycles_to_queue_by_license_operation(foo_id, 1000, executive_locked.id, 150, "TEST"));
+  check_totals();
+
+  // The totals follow the state when blocks are popped:
+  const auto before_submit = totals.total_cycles();
+  do_op(submit_cycles_to_queue_by_license_operation(foo_id, 500, standard_locked.id, 100, "TEST"));
+  BOOST_CHECK_EQUAL( totals.total_cycles().value, before_submit.value - 500 );
+  check_totals();
+  db.pop_block();
+  BOOST_CHECK_EQUAL( totals.total_cycles().value, before_submit.value );
+  check_totals();
+
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -26,6 +26,7 @@
 #include <graphene/chain/database.hpp>
 #include <graphene/chain/access_layer.hpp>
 #include <graphene/chain/exceptions.hpp>
+#include <graphene/chain/hardfork.hpp>
 
 #include <graphene/chain/license_objects.hpp>
 
@@ -240,6 +241,80 @@ BOOST_AUTO_TEST_CASE( limit_reset_test )
 
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE( batched_spend_limit_reset_test )
+{ try {
+  VAULT_ACTOR(vault);
+  const auto DSC_ID = get_dascoin_asset_id();
+  const auto& dgp = db.get_dynamic_global_properties();
+
+  // Batched resets are only done after the hardfork:
+  generate_blocks(HARDFORK_BLC_238_TIME);
+  generate_blocks(dgp.next_spend_limit_reset + fc::seconds(10));
+  BOOST_CHECK( !dgp.spend_limit_reset_cursor.valid() );
+
+  // Change the limit:
+  db.adjust_balance_limit(vault, DSC_ID, 1);
+  BOOST_CHECK_EQUAL( db.get_balance_object(vault_id, DSC_ID).limit.value, 1 );
+
+  // Wait for the limit interval to pass, all the vaults fit into a single batch:
+  generate_blocks(dgp.next_spend_limit_reset + fc::seconds(10));
+  BOOST_CHECK( !dgp.spend_limit_reset_cursor.valid() );
+
+  // The limit has been reset using the price sampled when the reset started:
+  const auto expected_limit = db.get_dascoin_limit(vault, dgp.last_daily_dascoin_price);
+  BOOST_REQUIRE( expected_limit.valid() );
+  BOOST_CHECK_EQUAL( db.get_balance_object(vault_id, DSC_ID).limit.value, expected_limit->value );
+  BOOST_CHECK_EQUAL( db.get_balance_object(vault_id, DSC_ID).spent.value, 0 );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( spend_limit_reset_spanning_blocks_test )
+{ try {
+  const auto DSC_ID = get_dascoin_asset_id();
+  const auto& dgp = db.get_dynamic_global_properties();
+
+  generate_blocks(HARDFORK_BLC_238_TIME);
+  generate_blocks(dgp.next_spend_limit_reset + fc::seconds(10));
+  BOOST_CHECK( !dgp.spend_limit_reset_cursor.valid() );
+  db.set_spend_limit_reset_batch_size(1);
+
+  VAULT_ACTOR(foo);
+  VAULT_ACTOR(bar);
+  VAULT_ACTOR(foobar);
+  db.adjust_balance_limit(foo, DSC_ID, 1);
+  db.adjust_balance_limit(bar, DSC_ID, 1);
+  db.adjust_balance_limit(foobar, DSC_ID, 1);
+
+  const auto& kind_idx = db.get_index_type<account_index>().indices().get<by_kind>();
+  const auto num_vaults = std::distance(kind_idx.lower_bound(boost::make_tuple(account_kind::vault)),
+                                        kind_idx.upper_bound(boost::make_tuple(account_kind::vault)));
+
+  // The first block after the reset time starts the sweep and resets the first vault only:
+  const time_point_sec reset_time = dgp.next_spend_limit_reset;
+  while( db.head_block_time() < reset_time )
+    generate_block();
+  BOOST_CHECK( dgp.spend_limit_reset_cursor.valid() );
+  BOOST_CHECK_EQUAL( db.get_balance_object(foobar_id, DSC_ID).limit.value, 1 );
+
+  // One vault per block, so the sweep spans as many blocks as there are vaults:
+  long blocks = 1;
+  while( dgp.spend_limit_reset_cursor.valid() && blocks <= num_vaults )
+  {
+    generate_block();
+    ++blocks;
+  }
+  BOOST_CHECK( !dgp.spend_limit_reset_cursor.valid() );
+  BOOST_CHECK_EQUAL( blocks, num_vaults );
+
+  // Every vault has been reset using the price sampled when the sweep started:
+  const auto expected_limit = db.get_dascoin_limit(foo, dgp.last_daily_dascoin_price);
+  BOOST_REQUIRE( expected_limit.valid() );
+  BOOST_CHECK_EQUAL( db.get_balance_object(foo_id, DSC_ID).limit.value, expected_limit->value );
+  BOOST_CHECK_EQUAL( db.get_balance_object(bar_id, DSC_ID).limit.value, expected_limit->value );
+  BOOST_CHECK_EQUAL( db.get_balance_object(foobar_id, DSC_ID).limit.value, expected_limit->value );
+
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_CASE( daily_dascoin_price_test )
 { try {
   const auto DSC_ID = get_dascoin_asset_id();
@@ -0,0 +1,213 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <graphene/net/peer_connection.hpp>
+#include <graphene/net/core_messages.hpp>
+
+#include <fc/network/tcp_socket.hpp>
+#include <fc/thread/thread.hpp>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+using namespace graphene::net;
+
+namespace {
+
+// records what the node's side of a connection is given, optionally taking its time handling each message
+class recording_delegate : public peer_connection_delegate
+{
+public:
+  std::vector<message>         messages;
+  std::vector<decoded_message> decoded;
+  uint32_t                     handled_on_other_thread = 0;
+  uint32_t                     connections_closed = 0;
+  fc::microseconds             handling_time;
+
+  void on_message( peer_connection*, const message& received_message, const message_hash_type&,
+                   const decoded_message& decoded_payload ) override
+  {
+    if( !_node_thread->is_current() )
+      ++handled_on_other_thread;
+    if( handling_time.count() )
+      fc::usleep( handling_time );
+    messages.push_back( received_message );
+    decoded.push_back( decoded_payload );
+  }
+  void on_connection_closed( peer_connection* ) override { ++connections_closed; }
+  shared_message_ptr get_message_for_item( const item_id& ) override { return shared_message_ptr(); }
+
+private:
+  fc::thread* _node_thread = &fc::thread::current();
+};
+
+// two peer connections over loopback, both reading on the threads of one message processing pool
+struct connected_peers
+{
+  message_processing_pool_ptr pool = std::make_shared<message_processing_pool>( 2 );
+  recording_delegate          inbound_delegate;
+  recording_delegate          outbound_delegate;
+  peer_connection_ptr         inbound;
+  peer_connection_ptr         outbound;
+
+  connected_peers()
+  {
+    inbound = peer_connection::make_shared( &inbound_delegate, pool );
+    outbound = peer_connection::make_shared( &outbound_delegate, pool );
+
+    fc::tcp_server server;
+    server.listen( fc::ip::endpoint( fc::ip::address( "127.0.0.1" ), 0 ) );
+    fc::future<void> accepted = fc::async( [&]() {
+      server.accept( inbound->get_socket() );
+      inbound->accept_connection();
+    }, "accept test connection" );
+    outbound->connect_to( fc::ip::endpoint( fc::ip::address( "127.0.0.1" ), server.get_local_endpoint().port() ) );
+    accepted.wait();
+  }
+
+  ~connected_peers()
+  {
+    inbound->destroy_connection();
+    outbound->destroy_connection();
+  }
+};
+
+template<typename Condition>
+bool wait_until( Condition condition )
+{
+  for( int i = 0; i < 500 && !condition(); ++i )
+    fc::usleep( fc::milliseconds( 10 ) );
+  return condition();
+}
+
+signed_transaction make_transaction( uint32_t expiration )
+{
+  signed_transaction trx;
+  transfer_operation transfer;
+  transfer.from = account_id_type( 1 );
+  transfer.to = account_id_type( 2 );
+  transfer.amount = asset( 1 );
+  trx.operations.push_back( transfer );
+  trx.expiration = fc::time_point_sec( expiration );
+  return trx;
+}
+
+}
+
+BOOST_FIXTURE_TEST_SUITE( dascoin_tests, database_fixture )
+
+BOOST_AUTO_TEST_SUITE( net_tests )
+
+BOOST_AUTO_TEST_CASE( message_processing_pool_exchange_test )
+{ try {
+  connected_peers peers;
+  BOOST_CHECK_EQUAL( peers.pool->connections.load(), 2u );
+
+  signed_transaction trx = make_transaction( 1000 );
+  signed_block block;
+  block.timestamp = fc::time_point_sec( 2000 );
+  block.transactions.push_back( processed_transaction( make_transaction( 3000 ) ) );
+
+  peers.outbound->send_message( message( trx_message( trx ) ) );
+  peers.outbound->send_message( message( block_message( block ) ) );
+  BOOST_REQUIRE( wait_until( [&]() { return peers.pool->messages_handled.load() == 2; } ) );
+
+  // the payloads were decoded on the pool, the messages handled on the node's thread, in the order they were sent
+  const recording_delegate& inbound = peers.inbound_delegate;
+  BOOST_REQUIRE_EQUAL( inbound.messages.size(), 2u );
+  BOOST_CHECK_EQUAL( inbound.handled_on_other_thread, 0u );
+
+  BOOST_CHECK_EQUAL( inbound.messages[0].msg_type, trx_message_type );
+  BOOST_REQUIRE( inbound.decoded[0].trx );
+  BOOST_CHECK( !inbound.decoded[0].block );
+  BOOST_CHECK( inbound.decoded[0].trx->trx.id() == trx.id() );
+
+  BOOST_CHECK_EQUAL( inbound.messages[1].msg_type, block_message_type );
+  BOOST_REQUIRE( inbound.decoded[1].block );
+  BOOST_CHECK( !inbound.decoded[1].trx );
+  BOOST_CHECK( inbound.decoded[1].block->block_id == block.id() );
+  BOOST_CHECK_EQUAL( inbound.decoded[1].block->block.transactions.size(), 1u );
+
+  // and the other way around, over the same sockets
+  peers.inbound->send_message( message( trx_message( trx ) ) );
+  BOOST_REQUIRE( wait_until( [&]() { return peers.outbound_delegate.messages.size() == 1; } ) );
+  BOOST_REQUIRE( peers.outbound_delegate.decoded[0].trx );
+  BOOST_CHECK( peers.outbound_delegate.decoded[0].trx->trx.id() == trx.id() );
+  BOOST_CHECK_EQUAL( peers.outbound_delegate.handled_on_other_thread, 0u );
+
+  BOOST_CHECK_EQUAL( peers.pool->messages_decoding.load(), 0u );
+  BOOST_CHECK_EQUAL( peers.pool->messages_waiting.load(), 0u );
+  BOOST_CHECK_EQUAL( peers.pool->messages_handling.load(), 0u );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( message_processing_pool_destroy_mid_read_test )
+{ try {
+  // the inbound side's read loop waits for data which never comes
+  {
+    connected_peers peers;
+    fc::usleep( fc::milliseconds( 50 ) );
+    peers.inbound->destroy_connection();
+    BOOST_CHECK_EQUAL( peers.inbound_delegate.connections_closed, 0u );
+
+    // the other side sees the connection go away
+    BOOST_CHECK( wait_until( [&]() { return peers.outbound_delegate.connections_closed == 1; } ) );
+  }
+
+  // closing a connection whose read is in progress ends the read loop
+  {
+    connected_peers peers;
+    fc::usleep( fc::milliseconds( 50 ) );
+    peers.outbound->close_connection();
+    BOOST_CHECK( wait_until( [&]() { return peers.outbound_delegate.connections_closed == 1; } ) );
+    BOOST_CHECK( wait_until( [&]() { return peers.inbound_delegate.connections_closed == 1; } ) );
+  }
+
+  // the inbound side is still handling a message on the node's thread while the next one waits to be read
+  {
+    connected_peers peers;
+    peers.inbound_delegate.handling_time = fc::milliseconds( 200 );
+    peers.outbound->send_message( message( trx_message( make_transaction( 1000 ) ) ) );
+    peers.outbound->send_message( message( trx_message( make_transaction( 2000 ) ) ) );
+    BOOST_REQUIRE( wait_until( [&]() { return peers.pool->messages_handling.load() == 1; } ) );
+
+    // destroying the connection waits for the message being handled, and drops the one behind it
+    peers.inbound->destroy_connection();
+    BOOST_CHECK_EQUAL( peers.inbound_delegate.messages.size(), 1u );
+    BOOST_CHECK_EQUAL( peers.inbound_delegate.connections_closed, 0u );
+    BOOST_CHECK_EQUAL( peers.pool->messages_handling.load(), 0u );
+
+    fc::usleep( fc::milliseconds( 300 ) );
+    BOOST_CHECK_EQUAL( peers.inbound_delegate.messages.size(), 1u );
+    BOOST_CHECK( wait_until( [&]() { return peers.outbound_delegate.connections_closed == 1; } ) );
+  }
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()  // dascoin_tests::net_tests
+
+BOOST_AUTO_TEST_SUITE_END()  // dascoin_tests
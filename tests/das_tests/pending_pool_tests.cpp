@@ -0,0 +1,209 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/exceptions.hpp>
+
+#include <graphene/chain/account_object.hpp>
+#include <graphene/chain/pending_transaction_pool.hpp>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+BOOST_FIXTURE_TEST_SUITE( dascoin_tests, database_fixture )
+
+BOOST_AUTO_TEST_CASE( pending_transaction_pool_test )
+{ try {
+  auto make_transfer = []( account_id_type from, share_type fee, uint32_t expiration ) {
+    signed_transaction trx;
+    transfer_operation t;
+    t.from = from;
+    t.to = account_id_type(1);
+    t.amount = asset(1);
+    t.fee = asset(fee);
+    trx.operations.push_back(t);
+    trx.expiration = fc::time_point_sec( expiration );
+    return processed_transaction( trx );
+  };
+  auto make_create = []( account_id_type registrar ) {
+    signed_transaction trx;
+    account_create_operation cop;
+    cop.registrar = registrar;
+    cop.name = "nathan";
+    trx.operations.push_back(cop);
+    return processed_transaction( trx );
+  };
+
+  pending_transaction_pool pool;
+  pending_pool_options options;
+  options.max_size = 4;
+  options.account_quota = 2;
+  options.operation_priorities[operation::tag<account_create_operation>::value] = 10;
+  pool.set_options( options );
+
+  vector<processed_transaction> pending;
+  auto push = [&]( const processed_transaction& trx ) {
+    auto evicted = pool.admit( trx );
+    if( evicted.valid() )
+    {
+      pending.erase( std::find_if( pending.begin(), pending.end(),
+                                   [&]( const processed_transaction& tx ) { return tx.id() == *evicted; } ) );
+      pool.evict( *evicted );
+    }
+    pending.push_back( trx );
+    pool.insert( trx );
+  };
+
+  push( make_transfer( account_id_type(2), 1, 1 ) );
+  push( make_transfer( account_id_type(2), 5, 2 ) );
+  push( make_transfer( account_id_type(3), 3, 3 ) );
+  push( make_create( account_id_type(3) ) );
+
+  // Account 2 is over its quota:
+  GRAPHENE_REQUIRE_THROW( pool.admit( make_transfer( account_id_type(2), 1, 4 ) ), fc::exception );
+
+  // Round robin over the fee payers, higher fees first; the account creation does not get ahead of the
+  // transfer paid by the same account before it:
+  vector<size_t> order = pool.block_order( pending );
+  BOOST_REQUIRE_EQUAL( order.size(), 4 );
+  BOOST_CHECK_EQUAL( order[0], 2 );
+  BOOST_CHECK_EQUAL( order[1], 0 );
+  BOOST_CHECK_EQUAL( order[2], 1 );
+  BOOST_CHECK_EQUAL( order[3], 3 );
+
+  // The pool is full, a transaction with no higher priority is rejected:
+  GRAPHENE_REQUIRE_THROW( pool.admit( make_transfer( account_id_type(4), 100, 5 ) ), fc::exception );
+
+  // A higher priority transaction evicts the lowest priority one with the lowest fee:
+  push( make_create( account_id_type(4) ) );
+  BOOST_REQUIRE_EQUAL( pending.size(), 4 );
+  BOOST_CHECK( pending.front().id() == make_transfer( account_id_type(2), 5, 2 ).id() );
+
+  order = pool.block_order( pending );
+  BOOST_CHECK_EQUAL( order[0], 3 );
+
+  pending_pool_stats stats = pool.get_stats();
+  BOOST_CHECK_EQUAL( stats.size, 4 );
+  BOOST_CHECK_EQUAL( stats.account_count, 3 );
+  BOOST_CHECK_EQUAL( stats.rejected, 2 );
+  BOOST_CHECK_EQUAL( stats.evicted, 1 );
+  BOOST_CHECK_EQUAL( stats.size_by_priority[10], 2 );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( pending_pool_eviction_test )
+{ try {
+  ACTOR(alice);
+  generate_block();
+  const public_key_type original_memo_key = alice_id(db).options.memo_key;
+
+  pending_pool_options options;
+  options.max_size = 1;
+  options.operation_priorities[operation::tag<account_create_operation>::value] = 10;
+  db.set_pending_pool_options( options );
+
+  // A low priority transaction changes alice's memo key in the pending state:
+  account_update_operation update;
+  update.account = alice_id;
+  update.new_options = alice_id(db).options;
+  update.new_options->memo_key = generate_private_key("memo").get_public_key();
+  set_expiration( db, trx );
+  trx.operations.clear();
+  trx.operations.push_back( update );
+  const transaction_id_type update_id = trx.id();
+  db.push_transaction( trx, ~0 );
+  BOOST_CHECK( alice_id(db).options.memo_key == update.new_options->memo_key );
+
+  // A higher priority transaction which fails does not evict anything:
+  trx.operations.clear();
+  trx.operations.push_back( make_account( account_kind::wallet, get_registrar_id(), "alice" ) );
+  GRAPHENE_REQUIRE_THROW( db.push_transaction( trx, ~0 ), fc::exception );
+  BOOST_CHECK( db.is_known_transaction( update_id ) );
+  BOOST_CHECK( alice_id(db).options.memo_key == update.new_options->memo_key );
+
+  // A valid one evicts the update. Its changes stay in the pending state until the next block rebuilds it:
+  trx.operations.clear();
+  trx.operations.push_back( make_account( account_kind::wallet, get_registrar_id(), "bob" ) );
+  db.push_transaction( trx, ~0 );
+  trx.operations.clear();
+  BOOST_CHECK( get_account( "bob" ).name == "bob" );
+  BOOST_CHECK( alice_id(db).options.memo_key == update.new_options->memo_key );
+
+  pending_pool_stats stats = db.get_pending_pool_stats();
+  BOOST_CHECK_EQUAL( stats.size, 1 );
+  BOOST_CHECK_EQUAL( stats.evicted, 1 );
+  BOOST_CHECK_EQUAL( stats.rejected, 0 );
+
+  const signed_block b = generate_block();
+  BOOST_CHECK_EQUAL( b.transactions.size(), 1 );
+  BOOST_CHECK( !db.is_known_transaction( update_id ) );
+  BOOST_CHECK( alice_id(db).options.memo_key == original_memo_key );
+  BOOST_CHECK( get_account( "bob" ).name == "bob" );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( pending_transactions_survive_block_test )
+{ try {
+  ACTOR(alice);
+  generate_block();
+
+  // A fully verified transaction, which records alice's authority as read:
+  account_update_operation update;
+  update.account = alice_id;
+  update.new_options = alice_id(db).options;
+  update.new_options->memo_key = generate_private_key("memo").get_public_key();
+  set_expiration( db, trx );
+  trx.operations.clear();
+  trx.operations.push_back( update );
+  sign( trx, alice_private_key );
+  const signed_transaction update_trx = trx;
+  trx.clear();
+  db.push_transaction( update_trx, database::skip_nothing );
+
+  // A block which does not contain the transaction, nor touches what its verification read:
+  signed_block b;
+  b.previous = db.head_block_id();
+  b.timestamp = db.get_slot_time(1);
+  b.witness = db.get_scheduled_witness(1);
+  b.transaction_merkle_root = b.calculate_merkle_root();
+  b.sign( init_account_priv_key );
+  db.push_block( b, database::skip_nothing );
+  BOOST_CHECK( db.head_block_id() == b.id() );
+
+  // The transaction is still pending on top of the new head:
+  BOOST_CHECK( db.is_known_transaction( update_trx.id() ) );
+  BOOST_CHECK( alice_id(db).options.memo_key == update.new_options->memo_key );
+  GRAPHENE_REQUIRE_THROW( db.push_transaction( update_trx, database::skip_nothing ), fc::exception );
+
+  const signed_block next = generate_block();
+  BOOST_CHECK_EQUAL( next.transactions.size(), 1 );
+  BOOST_CHECK( alice_id(db).options.memo_key == update.new_options->memo_key );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()